@@ -0,0 +1,59 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Per-run bump allocator shared by the GA programs; include it next to the
+// C sources, nothing to link.
+//
+// One block sized up front for the whole run. Allocation only bumps an
+// offset; arenaRewind drops everything allocated after a mark in one step,
+// which is how evolutionLoop releases a generation's temporaries. Nothing
+// is malloc'd or freed per generation and nothing large goes on the stack.
+
+typedef struct {
+    unsigned char *base;
+    size_t size;
+    size_t used;
+} Arena;
+
+#define ARENA_ALIGN 64   // Cache-line aligned blocks
+
+// Returns 0 when the block cannot be allocated
+static inline int arenaInit(Arena *arena, size_t size) {
+    arena->base = malloc(size);
+    arena->size = arena->base ? size : 0;
+    arena->used = 0;
+    return arena->base != NULL;
+}
+
+static inline void arenaFree(Arena *arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->size = arena->used = 0;
+}
+
+// Returns NULL when the arena is exhausted
+static inline void *arenaAlloc(Arena *arena, size_t bytes) {
+    uintptr_t next = (uintptr_t)(arena->base + arena->used);
+    size_t start = arena->used + (size_t)(-next & (ARENA_ALIGN - 1));
+    if (start > arena->size || bytes > arena->size - start) return NULL;
+    arena->used = start + bytes;
+    return arena->base + start;
+}
+
+static inline size_t arenaMark(const Arena *arena) {
+    return arena->used;
+}
+
+static inline void arenaRewind(Arena *arena, size_t mark) {
+    arena->used = mark;
+}
+
+// Bytes one arenaAlloc of the given size may take, padding included
+static inline size_t arenaBytes(size_t bytes) {
+    return bytes + ARENA_ALIGN - 1;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "board.h"
+
+// Check and microbenchmark for the Board<R,C> engine in board.cpp.
+//     g++ -O2 -std=c++17 -c board.cpp
+//     gcc -O2 bench_board.c board.o -lstdc++ -lm
+// For every supported size it scores random boards with boardCountThreatened,
+// boardPenalty and boardScore and compares each against the pairwise rules
+// the GA programs started from: rook on a shared row or column, bishop on a
+// shared diagonal, knight a (1,2) jump, queen rook or bishop, nothing blocks,
+// and one penalty per column holding more than one queen. Each board gets its
+// own fill rate so sparse and crowded placements are both covered. Any
+// mismatch is printed and the exit status is 1; then both evaluators are
+// timed per board.
+
+#define MAX_CELLS (16 * 16)
+#define BOARDS 2000
+#define ROUNDS 50       // Timing rounds at 4x4, scaled down with the cell count
+#define MAX_REPORTS 5   // Mismatches printed per size
+
+static const int sizes[][2] = {{4, 4}, {8, 8}, {10, 10}, {16, 16}};
+
+char boards[BOARDS][MAX_CELLS];
+
+int attacks(char piece, int r1, int c1, int r2, int c2) {
+    int dr = abs(r1 - r2);
+    int dc = abs(c1 - c2);
+    int line = (r1 == r2 || c1 == c2);
+    int diagonal = (dr == dc);
+
+    switch (piece) {
+        case 'Q': return line || diagonal;
+        case 'R': return line;
+        case 'B': return diagonal;
+        case 'K': return (dr == 2 && dc == 1) || (dr == 1 && dc == 2);
+    }
+    return 0;
+}
+
+// Reference: every ordered pair of pieces, O(cells^2)
+int pairwiseThreatened(int rows, int cols, const char chrom[], int threatenedPieces[]) {
+    int cells = rows * cols;
+    int numThreatened = 0;
+
+    for (int j = 0; j < cells; j++) threatenedPieces[j] = 0;
+
+    for (int i = 0; i < cells; i++) {
+        if (chrom[i] == 'E') continue;
+        for (int j = 0; j < cells; j++) {
+            if (j == i || chrom[j] == 'E' || threatenedPieces[j]) continue;
+            if (attacks(chrom[i], i / cols, i % cols, j / cols, j % cols)) {
+                threatenedPieces[j] = 1;
+                numThreatened++;
+            }
+        }
+    }
+    return numThreatened;
+}
+
+int pairwisePenalty(int rows, int cols, const char chrom[]) {
+    int penalty = 0;
+    for (int c = 0; c < cols; c++) {
+        int queens = 0;
+        for (int r = 0; r < rows; r++)
+            queens += chrom[r * cols + c] == 'Q';
+        penalty += queens > 1;
+    }
+    return penalty;
+}
+
+int pairwiseScore(int rows, int cols, const char chrom[]) {
+    int threatenedPieces[MAX_CELLS];
+    return pairwiseThreatened(rows, cols, chrom, threatenedPieces) +
+           pairwisePenalty(rows, cols, chrom);
+}
+
+void printChromosome(int rows, int cols, const char chrom[]) {
+    for (int r = 0; r < rows; r++) {
+        printf("    ");
+        for (int c = 0; c < cols; c++) printf("%c ", chrom[r * cols + c]);
+        printf("\n");
+    }
+}
+
+// Random pieces at a per-board fill rate between 0 and 100%
+void fillBoards(int cells) {
+    const char pieces[] = "QRBK";
+    for (int n = 0; n < BOARDS; n++) {
+        int fill = rand() % 101;
+        for (int i = 0; i < cells; i++)
+            boards[n][i] = rand() % 100 < fill ? pieces[rand() % 4] : 'E';
+    }
+}
+
+// Returns the number of boards on which any result differs
+int checkSize(int rows, int cols) {
+    int cells = rows * cols;
+    int failures = 0;
+
+    for (int n = 0; n < BOARDS; n++) {
+        const char *chrom = boards[n];
+        int expectedMarks[MAX_CELLS], marks[MAX_CELLS];
+        int expectedThreatened = pairwiseThreatened(rows, cols, chrom, expectedMarks);
+        int expectedPenalty = pairwisePenalty(rows, cols, chrom);
+
+        int threatened = boardCountThreatened(rows, cols, chrom, marks);
+        int penalty = boardPenalty(rows, cols, chrom);
+        int score = boardScore(rows, cols, chrom);
+
+        int badMarks = 0;
+        for (int i = 0; i < cells; i++) badMarks += marks[i] != expectedMarks[i];
+
+        if (threatened == expectedThreatened && penalty == expectedPenalty &&
+            score == expectedThreatened + expectedPenalty && !badMarks)
+            continue;
+
+        if (failures++ < MAX_REPORTS) {
+            printf("  board %d: threatened %d (expected %d), penalty %d (expected %d), "
+                   "score %d (expected %d), %d wrong marks\n",
+                   n, threatened, expectedThreatened, penalty, expectedPenalty,
+                   score, expectedThreatened + expectedPenalty, badMarks);
+            printChromosome(rows, cols, chrom);
+        }
+    }
+    return failures;
+}
+
+void timeScore(const char *name, int (*score)(int, int, const char[]), int rows, int cols) {
+    int rounds = ROUNDS * 16 / (rows * cols) + 1;
+    long checksum = 0;
+
+    clock_t start = clock();
+    for (int round = 0; round < rounds; round++)
+        for (int n = 0; n < BOARDS; n++)
+            checksum += score(rows, cols, boards[n]);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("  %-9s %10.1f ns/board   [checksum %ld]\n",
+           name, seconds * 1e9 / ((double)rounds * BOARDS), checksum);
+}
+
+int main() {
+    srand(time(NULL));
+    int failed = 0;
+
+    printf("=== BOARD ENGINE CHECK (%d boards per size) ===\n", BOARDS);
+
+    // Unsupported sizes are rejected rather than scored
+    char empty[MAX_CELLS];
+    for (int i = 0; i < MAX_CELLS; i++) empty[i] = 'E';
+    if (boardScore(5, 5, empty) != -1 || boardCountThreatened(4, 8, empty, NULL) != -1 ||
+        boardPenalty(3, 3, empty) != -1) {
+        printf("Unsupported size was not rejected with -1\n");
+        failed = 1;
+    }
+
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; s++) {
+        int rows = sizes[s][0];
+        int cols = sizes[s][1];
+
+        fillBoards(rows * cols);
+        int failures = checkSize(rows, cols);
+        printf("\n%dx%d: %s (%d of %d boards differ)\n", rows, cols,
+               failures ? "FAIL" : "ok", failures, BOARDS);
+        if (failures) failed = 1;
+
+        timeScore("pairwise", pairwiseScore, rows, cols);
+        timeScore("board", boardScore, rows, cols);
+    }
+
+    printf("\n%s\n", failed ? "BOARD CHECK FAILED" : "All sizes match the pairwise rules");
+    return failed;
+}
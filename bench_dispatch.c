@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// Microbenchmark for piece-type dispatch in the threat evaluator.
+// Scores the same random 4x4 boards three ways and reports time per board
+// plus branch instructions / branch misses from the CPU counters (Linux
+// perf_event_open; printed as n/a when counters are unavailable):
+//   1. pairwise   - the original O(SIZE^2) if/else chain on 'Q','R','B','K'
+//   2. switch     - attack bitboards, piece picked by a switch on the letter
+//   3. table      - boards hold a PieceType enum and index attackTable[type][from]
+
+#define SIZE 16
+#define ROWS 4
+#define COLS 4
+#define BOARDS 4096
+#define ROUNDS 200
+
+enum PieceType { EMPTY = 0, QUEEN, ROOK, BISHOP, KNIGHT, PIECE_TYPES };
+
+unsigned short attackTable[PIECE_TYPES][SIZE];
+
+char letterBoards[BOARDS][SIZE];
+char typeBoards[BOARDS][SIZE];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+
+        for (int t = 0; t < PIECE_TYPES; t++) attackTable[t][i] = 0;
+
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+
+            if (r1 == r2 || c1 == c2)
+                attackTable[ROOK][i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                attackTable[BISHOP][i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                attackTable[KNIGHT][i] |= bit;
+        }
+        attackTable[QUEEN][i] = attackTable[ROOK][i] | attackTable[BISHOP][i];
+    }
+}
+
+// 1. Original pairwise evaluator
+int threatenedPairwise(char chrom[]) {
+    int threatenedPieces[SIZE] = {0};
+    int numThreatened = 0;
+
+    for (int i = 0; i < SIZE; i++) {
+        if (chrom[i] == 'E') continue;
+
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+        char p1 = chrom[i];
+
+        for (int j = i + 1; j < SIZE; j++) {
+            if (chrom[j] == 'E') continue;
+
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            int threatFromItoJ = 0;
+            int threatFromJtoI = 0;
+
+            if (p1 == 'Q') {
+                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
+                    threatFromItoJ = 1;
+            } else if (p1 == 'R') {
+                if (r1 == r2 || c1 == c2)
+                    threatFromItoJ = 1;
+            } else if (p1 == 'B') {
+                if (abs(r1 - r2) == abs(c1 - c2))
+                    threatFromItoJ = 1;
+            } else if (p1 == 'K') {
+                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                    threatFromItoJ = 1;
+            }
+
+            char p2 = chrom[j];
+            if (p2 == 'Q') {
+                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
+                    threatFromJtoI = 1;
+            } else if (p2 == 'R') {
+                if (r1 == r2 || c1 == c2)
+                    threatFromJtoI = 1;
+            } else if (p2 == 'B') {
+                if (abs(r1 - r2) == abs(c1 - c2))
+                    threatFromJtoI = 1;
+            } else if (p2 == 'K') {
+                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                    threatFromJtoI = 1;
+            }
+
+            if (threatFromItoJ && !threatenedPieces[j]) {
+                threatenedPieces[j] = 1;
+                numThreatened++;
+            }
+            if (threatFromJtoI && !threatenedPieces[i]) {
+                threatenedPieces[i] = 1;
+                numThreatened++;
+            }
+        }
+    }
+
+    return numThreatened;
+}
+
+// 2. Bitboards with a switch on the piece letter
+int threatenedSwitch(char chrom[]) {
+    unsigned short occupied = 0;
+    unsigned short attacked = 0;
+
+    for (int i = 0; i < SIZE; i++) {
+        switch (chrom[i]) {
+            case 'Q': attacked |= attackTable[QUEEN][i]; break;
+            case 'R': attacked |= attackTable[ROOK][i]; break;
+            case 'B': attacked |= attackTable[BISHOP][i]; break;
+            case 'K': attacked |= attackTable[KNIGHT][i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
+    }
+
+    return __builtin_popcount(attacked & occupied);
+}
+
+// 3. Bitboards indexed by the stored piece type, no data-dependent branches
+int threatenedTable(char chrom[]) {
+    unsigned short occupied = 0;
+    unsigned short attacked = 0;
+
+    for (int i = 0; i < SIZE; i++) {
+        attacked |= attackTable[(int)chrom[i]][i];
+        occupied |= (unsigned short)((chrom[i] != EMPTY) << i);
+    }
+
+    return __builtin_popcount(attacked & occupied);
+}
+
+#ifdef __linux__
+int openCounter(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+void runBenchmark(const char *name, int (*evaluate)(char[]), char boards[][SIZE]) {
+    long long branches = -1, misses = -1;
+    long checksum = 0;
+
+#ifdef __linux__
+    int branchFd = openCounter(PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+    int missFd = openCounter(PERF_COUNT_HW_BRANCH_MISSES);
+    if (branchFd >= 0 && missFd >= 0) {
+        ioctl(branchFd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(missFd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(branchFd, PERF_EVENT_IOC_ENABLE, 0);
+        ioctl(missFd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++)
+        for (int n = 0; n < BOARDS; n++)
+            checksum += evaluate(boards[n]);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+#ifdef __linux__
+    if (branchFd >= 0 && missFd >= 0) {
+        ioctl(branchFd, PERF_EVENT_IOC_DISABLE, 0);
+        ioctl(missFd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(branchFd, &branches, sizeof branches) != sizeof branches) branches = -1;
+        if (read(missFd, &misses, sizeof misses) != sizeof misses) misses = -1;
+    }
+    if (branchFd >= 0) close(branchFd);
+    if (missFd >= 0) close(missFd);
+#endif
+
+    double evaluations = (double)ROUNDS * BOARDS;
+    printf("%-10s %10.1f ns/board", name, seconds * 1e9 / evaluations);
+    if (branches >= 0 && misses >= 0) {
+        printf(" %10.2f branches/board %8.3f misses/board (%.2f%%)",
+               branches / evaluations, misses / evaluations,
+               branches ? 100.0 * misses / branches : 0.0);
+    } else {
+        printf("   branches: n/a   misses: n/a");
+    }
+    printf("   [checksum %ld]\n", checksum);
+}
+
+int main() {
+    srand(time(NULL));
+    initAttackTables();
+
+    // Uniformly random cells give the predictor no pattern to learn
+    const char letters[] = "EQRBK";
+    for (int n = 0; n < BOARDS; n++) {
+        for (int i = 0; i < SIZE; i++) {
+            int t = rand() % PIECE_TYPES;
+            letterBoards[n][i] = letters[t];
+            typeBoards[n][i] = (char)t;
+        }
+    }
+
+    printf("=== PIECE DISPATCH MICROBENCHMARK (%d boards x %d rounds) ===\n", BOARDS, ROUNDS);
+    runBenchmark("pairwise", threatenedPairwise, letterBoards);
+    runBenchmark("switch", threatenedSwitch, letterBoards);
+    runBenchmark("table", threatenedTable, typeBoards);
+
+    return 0;
+}
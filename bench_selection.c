@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Microbenchmark for the td2.c selection operators.
+// Fitness values are drawn the way td2.c produces them: random placements of
+// a piece mix scored as 1 / (1 + threatened pieces + queen-column penalty).
+// Three distributions per population size:
+//   initial   - a freshly randomised population
+//   crowded   - a dense mix where almost every piece is threatened
+//   converged - 80% of the population already sits at the best score, as
+//               after a few generations of 20% elitism
+// Each operator fills a full parent list per round; the report gives time
+// per selected parent and the mean fitness of the parents (selection
+// pressure) next to the population mean:
+//   1. tournament k=2 / k=8 - partial Fisher-Yates over a kept permutation
+//   2. roulette             - Walker alias table, rebuilt every round
+//   3. sus                  - stochastic universal sampling plus a shuffle
+
+#define SIZE 16
+#define ROWS 4
+#define COLS 4
+#define PARENTS_PER_SIZE 4000000   // Parents selected per (distribution, size)
+
+unsigned short queenAttacks[SIZE];
+unsigned short rookAttacks[SIZE];
+unsigned short bishopAttacks[SIZE];
+unsigned short knightAttacks[SIZE];
+unsigned short columnMask[COLS];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+
+        rookAttacks[i] = bishopAttacks[i] = knightAttacks[i] = 0;
+
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+
+            if (r1 == r2 || c1 == c2)
+                rookAttacks[i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                bishopAttacks[i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                knightAttacks[i] |= bit;
+        }
+        queenAttacks[i] = rookAttacks[i] | bishopAttacks[i];
+    }
+
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
+// Threatened pieces + penalty, the integer part of fitness()
+int scorePlacement(char chrom[]) {
+    unsigned short occupied = 0, attacked = 0, queens = 0;
+
+    for (int i = 0; i < SIZE; i++) {
+        switch (chrom[i]) {
+            case 'Q': attacked |= queenAttacks[i]; queens |= (unsigned short)(1 << i); break;
+            case 'R': attacked |= rookAttacks[i]; break;
+            case 'B': attacked |= bishopAttacks[i]; break;
+            case 'K': attacked |= knightAttacks[i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
+    }
+
+    int score = __builtin_popcount(attacked & occupied);
+    for (int c = 0; c < COLS; c++) {
+        unsigned short inCol = queens & columnMask[c];
+        score += (inCol & (inCol - 1)) != 0;
+    }
+    return score;
+}
+
+// Fitness of one random placement of the given mix
+double randomFitness(const int counts[4]) {
+    const char pieces[4] = {'Q', 'R', 'B', 'K'};
+    char chrom[SIZE];
+    for (int i = 0; i < SIZE; i++) chrom[i] = 'E';
+
+    for (int t = 0; t < 4; t++) {
+        for (int placed = 0; placed < counts[t]; ) {
+            int pos = rand() % SIZE;
+            if (chrom[pos] == 'E') {
+                chrom[pos] = pieces[t];
+                placed++;
+            }
+        }
+    }
+    return 1.0 / (1.0 + scorePlacement(chrom));
+}
+
+static inline double randUnit() {
+    return rand() / ((double)RAND_MAX + 1.0);
+}
+
+// ---- Operators, as in td2.c ----
+
+void tournament(const double fitness[], int n, int k, int order[], int parents[]) {
+    for (int s = 0; s < n; s++) {
+        for (int j = 0; j < k; j++) {
+            int r = j + rand() % (n - j);
+            int temp = order[j];
+            order[j] = order[r];
+            order[r] = temp;
+        }
+        int best = order[0];
+        for (int j = 1; j < k; j++) {
+            if (fitness[order[j]] > fitness[best]) best = order[j];
+        }
+        parents[s] = best;
+    }
+}
+
+void roulette(const double fitness[], int n, double prob[], int alias[], int work[], int parents[]) {
+    double total = 0;
+    for (int i = 0; i < n; i++) total += fitness[i];
+
+    int small = 0, large = n;
+    for (int i = 0; i < n; i++) {
+        prob[i] = fitness[i] * n / total;
+        alias[i] = i;
+        if (prob[i] < 1.0) work[small++] = i;
+        else work[--large] = i;
+    }
+    while (small > 0 && large < n) {
+        int under = work[--small];
+        int over = work[large++];
+        alias[under] = over;
+        prob[over] -= 1.0 - prob[under];
+        if (prob[over] < 1.0) work[small++] = over;
+        else work[--large] = over;
+    }
+    while (small > 0) prob[work[--small]] = 1.0;
+    while (large < n) prob[work[large++]] = 1.0;
+
+    for (int s = 0; s < n; s++) {
+        int i = rand() % n;
+        parents[s] = randUnit() < prob[i] ? i : alias[i];
+    }
+}
+
+void sus(const double fitness[], int n, int parents[]) {
+    double total = 0;
+    for (int i = 0; i < n; i++) total += fitness[i];
+
+    double step = total / n;
+    double pointer = randUnit() * step;
+    double cumulative = fitness[0];
+    int i = 0;
+    for (int s = 0; s < n; s++) {
+        while (cumulative <= pointer && i < n - 1) cumulative += fitness[++i];
+        parents[s] = i;
+        pointer += step;
+    }
+    for (int s = n - 1; s > 0; s--) {
+        int r = rand() % (s + 1);
+        int temp = parents[s];
+        parents[s] = parents[r];
+        parents[r] = temp;
+    }
+}
+
+// ---- Harness ----
+
+enum { OP_TOURNAMENT2, OP_TOURNAMENT8, OP_ROULETTE, OP_SUS, OPERATORS };
+const char *operatorNames[OPERATORS] = {"tournament2", "tournament8", "roulette", "sus"};
+
+void runBenchmark(int op, const double fitness[], int n) {
+    int *order = malloc(n * sizeof *order);
+    int *parents = malloc(n * sizeof *parents);
+    int *alias = malloc(n * sizeof *alias);
+    int *work = malloc(n * sizeof *work);
+    double *prob = malloc(n * sizeof *prob);
+    if (!order || !parents || !alias || !work || !prob) {
+        printf("Cannot allocate buffers for %d individuals.\n", n);
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) order[i] = i;
+
+    int rounds = PARENTS_PER_SIZE / n;
+    if (rounds < 1) rounds = 1;
+    long checksum = 0;
+
+    clock_t start = clock();
+    for (int round = 0; round < rounds; round++) {
+        switch (op) {
+            case OP_TOURNAMENT2: tournament(fitness, n, 2, order, parents); break;
+            case OP_TOURNAMENT8: tournament(fitness, n, 8, order, parents); break;
+            case OP_ROULETTE: roulette(fitness, n, prob, alias, work, parents); break;
+            case OP_SUS: sus(fitness, n, parents); break;
+        }
+        checksum += parents[round % n];
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // Mean parent fitness over the last round, outside the timed loop
+    double lastMean = 0;
+    for (int s = 0; s < n; s++) lastMean += fitness[parents[s]];
+    lastMean /= n;
+
+    printf("  %-12s %8.1f ns/parent   parent mean %.4f   [checksum %ld]\n",
+           operatorNames[op], seconds * 1e9 / ((double)rounds * n), lastMean, checksum);
+
+    free(order);
+    free(parents);
+    free(alias);
+    free(work);
+    free(prob);
+}
+
+int main() {
+    srand(time(NULL));
+    initAttackTables();
+
+    const int sizes[] = {100, 1000, 100000};
+    const int initialMix[4] = {2, 2, 2, 2};
+    const int crowdedMix[4] = {4, 4, 2, 4};
+    const char *names[3] = {"initial", "crowded", "converged"};
+
+    printf("=== SELECTION OPERATOR MICROBENCHMARK (%d parents per run) ===\n", PARENTS_PER_SIZE);
+    for (int z = 0; z < (int)(sizeof sizes / sizeof sizes[0]); z++) {
+        int n = sizes[z];
+        double *fitness = malloc(n * sizeof *fitness);
+        if (!fitness) {
+            printf("Cannot allocate a population of %d.\n", n);
+            return 1;
+        }
+
+        for (int d = 0; d < 3; d++) {
+            double best = 0, mean = 0;
+            for (int i = 0; i < n; i++) {
+                fitness[i] = randomFitness(d == 1 ? crowdedMix : initialMix);
+                if (fitness[i] > best) best = fitness[i];
+            }
+            if (d == 2) {
+                for (int i = 0; i < n; i++)
+                    if (rand() % 5 != 0) fitness[i] = best;
+            }
+            for (int i = 0; i < n; i++) mean += fitness[i];
+            mean /= n;
+
+            printf("\n%s, population %d (mean fitness %.4f, best %.4f)\n", names[d], n, mean, best);
+            for (int op = 0; op < OPERATORS; op++) runBenchmark(op, fitness, n);
+        }
+        free(fitness);
+    }
+
+    return 0;
+}
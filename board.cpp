@@ -0,0 +1,192 @@
+#include "board.h"
+
+#include <array>
+#include <cstdint>
+
+// Board<R,C> builds every attack mask for an R x C board at compile time.
+// Masks are arrays of 64-bit words, so the same code covers 4x4 (one word)
+// up to 16x16 (four words). Scoring a chromosome walks the cells in order and
+// never divides, takes a modulo or branches on geometry: the cell index is
+// split into word/bit with shifts, and the piece type selects its mask table
+// through a lookup instead of an if/else chain.
+
+namespace {
+
+enum PieceType { EMPTY = 0, QUEEN, ROOK, BISHOP, KNIGHT, PIECE_TYPES };
+
+struct PieceLookup {
+    unsigned char type[256];
+};
+
+constexpr PieceLookup buildPieceLookup() {
+    PieceLookup lookup{};
+    lookup.type[(unsigned char)'Q'] = QUEEN;
+    lookup.type[(unsigned char)'R'] = ROOK;
+    lookup.type[(unsigned char)'B'] = BISHOP;
+    lookup.type[(unsigned char)'K'] = KNIGHT;
+    return lookup;
+}
+
+constexpr PieceLookup pieceLookup = buildPieceLookup();
+
+constexpr int absDiff(int a, int b) {
+    return a > b ? a - b : b - a;
+}
+
+template <int R, int C>
+struct Board {
+    static constexpr int N = R * C;
+    static constexpr int WORDS = (N + 63) / 64;
+
+    using Mask = std::array<std::uint64_t, WORDS>;
+
+    struct Tables {
+        Mask row[N];
+        Mask col[N];
+        Mask diagonal[N];      // Both diagonals through the square
+        Mask knight[N];
+        Mask attacks[PIECE_TYPES][N];   // Indexed by PieceType; EMPTY stays zero
+        Mask column[C];
+    };
+
+    static constexpr void setBit(Mask &m, int sq) {
+        m[sq >> 6] |= std::uint64_t(1) << (sq & 63);
+    }
+
+    static constexpr Tables build() {
+        Tables t{};
+
+        for (int r1 = 0; r1 < R; r1++) {
+            for (int c1 = 0; c1 < C; c1++) {
+                int i = r1 * C + c1;
+
+                for (int r2 = 0; r2 < R; r2++) {
+                    for (int c2 = 0; c2 < C; c2++) {
+                        int j = r2 * C + c2;
+                        if (j == i) continue;
+
+                        int dr = absDiff(r1, r2);
+                        int dc = absDiff(c1, c2);
+
+                        if (r1 == r2) setBit(t.row[i], j);
+                        if (c1 == c2) setBit(t.col[i], j);
+                        if (dr == dc) setBit(t.diagonal[i], j);
+                        if ((dr == 2 && dc == 1) || (dr == 1 && dc == 2)) setBit(t.knight[i], j);
+                    }
+                }
+
+                for (int w = 0; w < WORDS; w++) {
+                    t.attacks[ROOK][i][w] = t.row[i][w] | t.col[i][w];
+                    t.attacks[BISHOP][i][w] = t.diagonal[i][w];
+                    t.attacks[QUEEN][i][w] = t.row[i][w] | t.col[i][w] | t.diagonal[i][w];
+                    t.attacks[KNIGHT][i][w] = t.knight[i][w];
+                }
+
+                setBit(t.column[c1], i);
+            }
+        }
+        return t;
+    }
+
+    static constexpr Tables tables = build();
+
+    // Fill occupancy, queen and attacked masks for one chromosome
+    static void scan(const char chrom[], Mask &occupied, Mask &queens, Mask &attacked) {
+        occupied = Mask{};
+        queens = Mask{};
+        attacked = Mask{};
+
+        for (int sq = 0; sq < N; sq++) {
+            unsigned type = pieceLookup.type[(unsigned char)chrom[sq]];
+            std::uint64_t bit = std::uint64_t(1) << (sq & 63);
+            occupied[sq >> 6] |= bit & (std::uint64_t(0) - (type != EMPTY));
+            queens[sq >> 6] |= bit & (std::uint64_t(0) - (type == QUEEN));
+
+            const Mask &a = tables.attacks[type][sq];
+            for (int w = 0; w < WORDS; w++) attacked[w] |= a[w];
+        }
+    }
+
+    static int penalty(const Mask &queens) {
+        int penalty = 0;
+        for (int c = 0; c < C; c++) {
+            int inCol = 0;
+            for (int w = 0; w < WORDS; w++)
+                inCol += __builtin_popcountll(queens[w] & tables.column[c][w]);
+            penalty += inCol > 1;
+        }
+        return penalty;
+    }
+
+    static int countThreatened(const char chrom[], int threatenedPieces[]) {
+        Mask occupied, queens, attacked;
+        scan(chrom, occupied, queens, attacked);
+
+        int numThreatened = 0;
+        for (int w = 0; w < WORDS; w++) {
+            std::uint64_t threatened = attacked[w] & occupied[w];
+            numThreatened += __builtin_popcountll(threatened);
+            if (threatenedPieces) {
+                int base = w << 6;
+                int limit = N - base < 64 ? N - base : 64;
+                for (int b = 0; b < limit; b++)
+                    threatenedPieces[base + b] = (int)((threatened >> b) & 1);
+            }
+        }
+        return numThreatened;
+    }
+
+    static int penalty(const char chrom[]) {
+        Mask occupied, queens, attacked;
+        scan(chrom, occupied, queens, attacked);
+        return penalty(queens);
+    }
+
+    static int score(const char chrom[]) {
+        Mask occupied, queens, attacked;
+        scan(chrom, occupied, queens, attacked);
+
+        int total = penalty(queens);
+        for (int w = 0; w < WORDS; w++)
+            total += __builtin_popcountll(attacked[w] & occupied[w]);
+        return total;
+    }
+};
+
+// Compile-time sanity checks on the generated geometry
+static_assert(Board<4, 4>::tables.attacks[QUEEN][0][0] == 0x953EULL,
+              "4x4 queen on a1 attacks its row, column and diagonal");
+static_assert(Board<4, 4>::tables.knight[0][0] == ((1ULL << 6) | (1ULL << 9)),
+              "4x4 knight on a1 reaches two squares");
+static_assert(Board<8, 8>::tables.column[0][0] == 0x0101010101010101ULL,
+              "8x8 first column mask");
+
+// Dispatch a runtime size to the matching instantiation
+template <typename Fn>
+int withBoard(int rows, int cols, Fn fn) {
+    if (rows == 4 && cols == 4) return fn(Board<4, 4>());
+    if (rows == 8 && cols == 8) return fn(Board<8, 8>());
+    if (rows == 10 && cols == 10) return fn(Board<10, 10>());
+    if (rows == 16 && cols == 16) return fn(Board<16, 16>());
+    return -1;
+}
+
+} // namespace
+
+extern "C" int boardCountThreatened(int rows, int cols, const char chrom[], int threatenedPieces[]) {
+    return withBoard(rows, cols, [&](auto board) {
+        return decltype(board)::countThreatened(chrom, threatenedPieces);
+    });
+}
+
+extern "C" int boardPenalty(int rows, int cols, const char chrom[]) {
+    return withBoard(rows, cols, [&](auto board) {
+        return decltype(board)::penalty(chrom);
+    });
+}
+
+extern "C" int boardScore(int rows, int cols, const char chrom[]) {
+    return withBoard(rows, cols, [&](auto board) {
+        return decltype(board)::score(chrom);
+    });
+}
@@ -0,0 +1,31 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+// C interface to the templated Board<R,C> engine in board.cpp.
+// Build board.cpp with a C++17 compiler and link it next to the C sources:
+//     g++ -O2 -std=c++17 -c board.cpp
+//     gcc -O2 program.c board.o -lstdc++ -lm
+//
+// Chromosomes hold rows * cols cells of 'E', 'Q', 'R', 'B', 'K' in row-major
+// order. Supported sizes are 4x4, 8x8, 10x10 and 16x16; every function
+// returns -1 for any other size.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counts number of threatened pieces (not number of threats) and marks them
+// in threatenedPieces[] (rows * cols entries)
+int boardCountThreatened(int rows, int cols, const char chrom[], int threatenedPieces[]);
+
+// Number of columns holding more than one queen
+int boardPenalty(int rows, int cols, const char chrom[]);
+
+// Threatened pieces + penalty, i.e. the denominator term of 1 / (1 + score)
+int boardScore(int rows, int cols, const char chrom[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef FITCACHE_H
+#define FITCACHE_H
+
+#include <stdio.h>
+
+// Fitness memo shared by the GA programs; include it next to the C sources,
+// nothing to link.
+//
+// Fixed-size open-addressing table keyed by the chromosome packed at 3 bits
+// per cell, so boards of up to 21 cells fit in one key (48 bits for the 4x4
+// board). Bit 63 marks a used slot, so an all-zero entry is free. When a
+// probe window is full the home slot is overwritten. Besides the fitness an
+// entry keeps two score components for programs that print or rank by them.
+#define CACHE_BITS 16
+#define CACHE_SIZE (1 << CACHE_BITS)
+#define CACHE_PROBES 8
+#define CACHE_USED (1ULL << 63)
+
+typedef struct {
+    unsigned long long key;
+    double fit;
+    int parts[2];
+} CacheEntry;
+
+static CacheEntry fitnessCache[CACHE_SIZE];
+static long long cacheHits = 0;
+static long long cacheMisses = 0;
+
+static inline unsigned long long cacheKey(const char chrom[], int cells) {
+    unsigned long long key = 0;
+    for (int i = 0; i < cells; i++) {
+        unsigned long long code = 0;
+        switch (chrom[i]) {
+            case 'Q': code = 1; break;
+            case 'R': code = 2; break;
+            case 'B': code = 3; break;
+            case 'K': code = 4; break;
+        }
+        key |= code << (3 * i);
+    }
+    return key | CACHE_USED;
+}
+
+// Points *entry at the chromosome's slot. Returns 1 on a hit; on a miss the
+// slot is claimed for the chromosome and the caller fills in its score.
+static inline int cacheLookup(const char chrom[], int cells, CacheEntry **entry) {
+    unsigned long long key = cacheKey(chrom, cells);
+    unsigned int home = (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> (64 - CACHE_BITS));
+    CacheEntry *slot = &fitnessCache[home];
+
+    for (int p = 0; p < CACHE_PROBES; p++) {
+        CacheEntry *e = &fitnessCache[(home + p) & (CACHE_SIZE - 1)];
+        if (e->key == key) {
+            cacheHits++;
+            *entry = e;
+            return 1;
+        }
+        if (e->key == 0) {
+            slot = e;
+            break;
+        }
+    }
+
+    cacheMisses++;
+    slot->key = key;
+    *entry = slot;
+    return 0;
+}
+
+static void printCacheStats(void) {
+    long long total = cacheHits + cacheMisses;
+    printf("Fitness cache: %lld hits, %lld misses (%.1f%% hit rate)\n",
+           cacheHits, cacheMisses, total ? 100.0 * cacheHits / total : 0.0);
+}
+
+#endif
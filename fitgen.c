@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Offline generator for the exhaustive 4x4 fitness lookup table.
+// For one piece mix (nQ, nR, nB, nK) it scores every valid placement and
+// writes fitness_<nQ>_<nR>_<nB>_<nK>.tbl, which td2.c memory-maps at startup.
+//
+// File layout: 16-byte header followed by one byte per placement holding
+// threatened pieces + queen-column penalty, indexed by rankPlacement().
+
+#define SIZE 16
+#define ROWS 4
+#define COLS 4
+
+typedef struct {
+    char magic[4];                // "FTB1"
+    unsigned char counts[4];      // nQ, nR, nB, nK
+    unsigned long long entries;   // number of placements that follow
+} TableHeader;
+
+#define NO_RANK (~0ULL)
+
+unsigned short queenAttacks[SIZE];
+unsigned short rookAttacks[SIZE];
+unsigned short bishopAttacks[SIZE];
+unsigned short knightAttacks[SIZE];
+unsigned short columnMask[COLS];
+unsigned long long binom[SIZE + 1][SIZE + 1];
+
+char pieces[4] = {'Q', 'R', 'B', 'K'};
+int counts[4];
+unsigned char *table;
+unsigned long long filled = 0;
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+
+        rookAttacks[i] = bishopAttacks[i] = knightAttacks[i] = 0;
+
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+
+            if (r1 == r2 || c1 == c2)
+                rookAttacks[i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                bishopAttacks[i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                knightAttacks[i] |= bit;
+        }
+        queenAttacks[i] = rookAttacks[i] | bishopAttacks[i];
+    }
+
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
+void initBinomials() {
+    for (int n = 0; n <= SIZE; n++) {
+        binom[n][0] = 1;
+        for (int k = 1; k <= SIZE; k++)
+            binom[n][k] = (n == 0) ? 0 : binom[n - 1][k - 1] + binom[n - 1][k];
+    }
+}
+
+// Threatened pieces + penalty, the integer part of fitness()
+int scorePlacement(char chrom[]) {
+    unsigned short occupied = 0, attacked = 0, queens = 0;
+
+    for (int i = 0; i < SIZE; i++) {
+        switch (chrom[i]) {
+            case 'Q': attacked |= queenAttacks[i]; queens |= (unsigned short)(1 << i); break;
+            case 'R': attacked |= rookAttacks[i]; break;
+            case 'B': attacked |= bishopAttacks[i]; break;
+            case 'K': attacked |= knightAttacks[i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
+    }
+
+    int score = __builtin_popcount(attacked & occupied);
+    for (int c = 0; c < COLS; c++) {
+        unsigned short inCol = queens & columnMask[c];
+        score += (inCol & (inCol - 1)) != 0;
+    }
+    return score;
+}
+
+// Rank of a placement in the combinatorial number system: queens are ranked
+// among all cells, rooks among the cells left after queens, and so on; the
+// four ranks are then combined as a mixed-radix number.
+unsigned long long rankPlacement(char chrom[]) {
+    int seen[4] = {0};
+    int level[4] = {0};   // Index of the current cell among cells free at each level
+    unsigned long long part[4] = {0};
+
+    for (int i = 0; i < SIZE; i++) {
+        int t;
+        switch (chrom[i]) {
+            case 'Q': t = 0; break;
+            case 'R': t = 1; break;
+            case 'B': t = 2; break;
+            case 'K': t = 3; break;
+            default:  t = 4; break;
+        }
+        for (int l = 0; l <= t && l < 4; l++) {
+            if (l == t) part[t] += binom[level[t]][++seen[t]];
+            level[l]++;
+        }
+    }
+
+    for (int t = 0; t < 4; t++)
+        if (seen[t] != counts[t]) return NO_RANK;
+
+    unsigned long long rank = 0;
+    int freeCells = SIZE;
+    for (int t = 0; t < 4; t++) {
+        rank = rank * binom[freeCells][counts[t]] + part[t];
+        freeCells -= counts[t];
+    }
+    return rank;
+}
+
+unsigned long long tableEntries() {
+    unsigned long long entries = 1;
+    int freeCells = SIZE;
+    for (int t = 0; t < 4; t++) {
+        entries *= binom[freeCells][counts[t]];
+        freeCells -= counts[t];
+    }
+    return entries;
+}
+
+// Place each piece type in increasing cell order, so every placement is
+// visited exactly once
+void enumerate(char chrom[], int type, int left, int from) {
+    if (left == 0) {
+        if (type == 3) {
+            table[rankPlacement(chrom)] = (unsigned char)scorePlacement(chrom);
+            filled++;
+            return;
+        }
+        enumerate(chrom, type + 1, counts[type + 1], 0);
+        return;
+    }
+
+    for (int i = from; i < SIZE; i++) {
+        if (chrom[i] != 'E') continue;
+        chrom[i] = pieces[type];
+        enumerate(chrom, type, left - 1, i + 1);
+        chrom[i] = 'E';
+    }
+}
+
+int main() {
+    printf("=== 4x4 FITNESS TABLE GENERATOR ===\n");
+
+    while (1) {
+        printf("Enter number of Queens (0-16): ");
+        scanf("%d", &counts[0]);
+        printf("Enter number of Rooks (0-16): ");
+        scanf("%d", &counts[1]);
+        printf("Enter number of Bishops (0-16): ");
+        scanf("%d", &counts[2]);
+        printf("Enter number of Knights (0-16): ");
+        scanf("%d", &counts[3]);
+
+        int total = counts[0] + counts[1] + counts[2] + counts[3];
+        if (counts[0] < 0 || counts[1] < 0 || counts[2] < 0 || counts[3] < 0) {
+            printf("Piece counts cannot be negative.\n");
+            continue;
+        }
+        if (total > SIZE) {
+            printf("Total pieces cannot exceed 16. Currently: %d\n", total);
+            continue;
+        }
+        break;
+    }
+
+    initAttackTables();
+    initBinomials();
+
+    unsigned long long entries = tableEntries();
+    printf("Placements to score: %llu\n", entries);
+
+    table = malloc(entries);
+    if (!table) {
+        printf("Cannot allocate %llu bytes.\n", entries);
+        return 1;
+    }
+    memset(table, 0xFF, entries);
+
+    char chrom[SIZE];
+    for (int i = 0; i < SIZE; i++) chrom[i] = 'E';
+    enumerate(chrom, 0, counts[0], 0);
+
+    // Every rank must be hit exactly once
+    for (unsigned long long i = 0; i < entries; i++) {
+        if (table[i] == 0xFF) {
+            printf("Rank %llu was never produced.\n", i);
+            return 1;
+        }
+    }
+    if (filled != entries) {
+        printf("Enumerated %llu placements, expected %llu.\n", filled, entries);
+        return 1;
+    }
+
+    char filename[64];
+    sprintf(filename, "fitness_%d_%d_%d_%d.tbl", counts[0], counts[1], counts[2], counts[3]);
+
+    FILE *out = fopen(filename, "wb");
+    if (!out) {
+        printf("Cannot open %s for writing.\n", filename);
+        return 1;
+    }
+
+    TableHeader header;
+    memcpy(header.magic, "FTB1", 4);
+    for (int t = 0; t < 4; t++) header.counts[t] = (unsigned char)counts[t];
+    header.entries = entries;
+
+    if (fwrite(&header, sizeof header, 1, out) != 1 ||
+        fwrite(table, 1, entries, out) != entries) {
+        printf("Write to %s failed.\n", filename);
+        fclose(out);
+        return 1;
+    }
+    fclose(out);
+    free(table);
+
+    printf("Wrote %s (%llu entries)\n", filename, entries);
+    return 0;
+}
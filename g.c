@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -64,7 +66,7 @@ void Conflicts(char chrom[], int out[]) {
     }
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int conflicts[SIZE];
     Conflicts(chrom, conflicts);
     int nb_conflicts = 0;
@@ -73,6 +75,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1 + nb_conflicts);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -94,13 +103,10 @@ void copyArray(char dest[], char src[]) {
     for (int i = 0; i < SIZE; i++)
         dest[i] = src[i];
 }
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Picks 6 distinct winners and returns their indices in parents[]; nothing
+// is copied, crossover reads the winners in place
+void tournamentSelection(double fitnessScores[], int parents[6]) 
 {
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < SIZE; j++)
-            selected[i][j] = 'E';
-
     double tempFitnessScores[POPULATION];
     for (int k = 0; k < POPULATION; k++) {
         tempFitnessScores[k] = fitnessScores[k];
@@ -122,46 +128,33 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
             winner = b;
         }
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
+        parents[s] = winner;
         tempFitnessScores[winner] = -1.0; 
     }
 }
-void crossover(char selected[6][SIZE], double selectedFitness[],
+// Final population: the first 4 parents followed by the 6 children. Parents
+// are read in place from population[parents[i]] and written straight into
+// finalPopulation, with no intermediate pool.
+void crossover(char population[][SIZE], double fitnessScores[], int parents[6],
                char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
 {
-    char tempPopulation[12][SIZE];
-    double tempFitness[12];
-
-    for (int i = 0; i < 12; i++)
-        for (int j = 0; j < SIZE; j++)
-            tempPopulation[i][j] = 'E';
-    for (int i = 0; i < 6; i++) {
-        copyArray(tempPopulation[i], selected[i]);
-        tempFitness[i] = selectedFitness[i];
+    for (int i = 0; i < 4; i++) {
+        copyArray(finalPopulation[i], population[parents[i]]);
+        finalFitness[i] = fitnessScores[parents[i]];
     }
-    int nextChild = 6;
+    int nextChild = 4;
     for (int p = 0; p < 3; p++) {
-        int p1 = p * 2;
-        int p2 = p * 2 + 1;
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        char *p1 = population[parents[p * 2]];
+        char *p2 = population[parents[p * 2 + 1]];
+        for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p1[i];
+        for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p2[i];
+        finalFitness[nextChild] = fitness(finalPopulation[nextChild]);
         nextChild++;
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p2[i];
+        for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p1[i];
+        finalFitness[nextChild] = fitness(finalPopulation[nextChild]);
         nextChild++;
     }
-
-    for (int i = 0; i < 4; i++) {
-        copyArray(finalPopulation[i], tempPopulation[i]);
-        finalFitness[i] = tempFitness[i];
-    }
-    for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i + 4], tempPopulation[i + 6]);
-        finalFitness[i + 4] = tempFitness[i + 6];
-    }
 }
 void mutation(char population[][SIZE], double fitnessScores[],
               int nQ, int nR, int nB, int nK)
@@ -238,19 +231,18 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             currentFitness[i] = fitnessScores[i];
         }
 
-        char selected[6][SIZE];
-        double selectedFitness[6];
+        int parents[6];
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
         char newPopulation[POPULATION][SIZE];
         double newFitness[POPULATION];
         
-        tournamentSelection(population, currentFitness, selected, selectedFitness);
+        tournamentSelection(currentFitness, parents);
         for (int i = 0; i < POPULATION; i++) {
             fitnessScores[i] = fitness(population[i]);
         }
 
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, fitnessScores, parents, offspring, offspringFitness);
         mutation(offspring, offspringFitness, nQ, nR, nB, nK);
         replacement(population, fitnessScores, offspring, offspringFitness, 
                     newPopulation, newFitness);
@@ -275,6 +267,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             break;
         }
     }
+    printCacheStats();
 }
 int main() {
     srand(time(NULL));
@@ -325,15 +318,14 @@ int main() {
         fitnessScores[i] = fitness(population[i]);
     }
     
-    char selected[6][SIZE];
-    double selectedFitness[6];
+    int parents[6];
     char finalPopulation[POPULATION][SIZE];
     double finalFitness[POPULATION];
 
     double initialFitnessCopy[POPULATION];
     for(int i = 0; i < POPULATION; i++) initialFitnessCopy[i] = fitnessScores[i];
-    tournamentSelection(population, initialFitnessCopy, selected, selectedFitness);
-    crossover(selected, selectedFitness, finalPopulation, finalFitness);
+    tournamentSelection(initialFitnessCopy, parents);
+    crossover(population, fitnessScores, parents, finalPopulation, finalFitness);
     mutation(finalPopulation, finalFitness, nQ, nR, nB, nK);
     char best10[POPULATION][SIZE];
     double best10Fitness[POPULATION];
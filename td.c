@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 // Global parameters that can be set by user
 int MAX_GENERATIONS = 100;
 int POPULATION_SIZE = 10;
@@ -118,7 +120,7 @@ int countThreatenedPieces(char chrom[], int threatenedPieces[]) {
     return numThreatened;
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int threatenedPieces[SIZE];
     int nb_conflicts = countThreatenedPieces(chrom, threatenedPieces);
     int penalty = calculatePenalty(chrom);
@@ -126,6 +128,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_conflicts + penalty);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -165,9 +174,8 @@ void copyArray(char dest[], char src[]) {
 }
 
 // Tournament selection with probability-based selection
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[][SIZE], double selectedFitness[], 
-                         int numSelected) 
+// Winners go into parents[] as population indices; nothing is copied
+void tournamentSelection(double fitnessScores[], int parents[], int numSelected) 
 {
     printf("\n=== TOURNAMENT SELECTION START ===\n");
     
@@ -184,8 +192,7 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
         // Choose the better one (higher fitness)
         int winner = (fitnessScores[a] > fitnessScores[b]) ? a : b;
         
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = fitnessScores[winner];
+        parents[s] = winner;
         
         printf("Selection %d: Chose individual %d (Fitness=%.4f)\n", 
                s, winner, fitnessScores[winner]);
@@ -194,8 +201,8 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
     printf("=== TOURNAMENT SELECTION END ===\n");
 }
 
-// Crossover with probability PC
-void crossover(char population[][SIZE], double fitnessScores[],
+// Crossover with probability PC; parents are read in place through parents[]
+void crossover(char population[][SIZE], int parents[],
                char offspring[][SIZE], double offspringFitness[]) 
 {
     printf("\n=== CROSSOVER START (Pc=%.1f) ===\n", PC);
@@ -206,6 +213,8 @@ void crossover(char population[][SIZE], double fitnessScores[],
     for (int i = 0; i < POPULATION_SIZE; i += 2) {
         if (i + 1 >= POPULATION_SIZE) break;
         
+        char *parent1 = population[parents[i]];
+        char *parent2 = population[parents[i + 1]];
         double randVal = (double)rand() / RAND_MAX;
         
         if (randVal < PC) {
@@ -214,18 +223,18 @@ void crossover(char population[][SIZE], double fitnessScores[],
             
             // Parent 1
             for (int j = 0; j < crossoverPoint; j++) {
-                offspring[offspringCount][j] = population[i][j];
+                offspring[offspringCount][j] = parent1[j];
             }
             for (int j = crossoverPoint; j < SIZE; j++) {
-                offspring[offspringCount][j] = population[i + 1][j];
+                offspring[offspringCount][j] = parent2[j];
             }
             
             // Parent 2
             for (int j = 0; j < crossoverPoint; j++) {
-                offspring[offspringCount + 1][j] = population[i + 1][j];
+                offspring[offspringCount + 1][j] = parent2[j];
             }
             for (int j = crossoverPoint; j < SIZE; j++) {
-                offspring[offspringCount + 1][j] = population[i][j];
+                offspring[offspringCount + 1][j] = parent1[j];
             }
             
             printf("Crossover between %d and %d at point %d\n", 
@@ -234,8 +243,8 @@ void crossover(char population[][SIZE], double fitnessScores[],
             offspringCount += 2;
         } else {
             // No crossover, just copy parents
-            copyArray(offspring[offspringCount], population[i]);
-            copyArray(offspring[offspringCount + 1], population[i + 1]);
+            copyArray(offspring[offspringCount], parent1);
+            copyArray(offspring[offspringCount + 1], parent2);
             
             printf("No crossover for %d and %d\n", i, i + 1);
             
@@ -392,12 +401,11 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[], int generati
         double offspringFitness[POPULATION_SIZE];
         
         // Selection (tournament selection)
-        char selected[POPULATION_SIZE][SIZE];
-        double selectedFitness[POPULATION_SIZE];
-        tournamentSelection(population, fitnessScores, selected, selectedFitness, POPULATION_SIZE);
+        int parents[POPULATION_SIZE];
+        tournamentSelection(fitnessScores, parents, POPULATION_SIZE);
         
         // Crossover
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, parents, offspring, offspringFitness);
         
         // Mutation
         mutation(offspring, offspringFitness, POPULATION_SIZE);
@@ -435,6 +443,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[], int generati
     }
     
     printf("\n=== EVOLUTION LOOP END ===\n");
+    printCacheStats();
 }
 
 int main() {
@@ -2,11 +2,31 @@
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 // Global parameters that can be set by user
 int MAX_GENERATIONS = 100;
 int POPULATION_SIZE = 10;
+int TOURNAMENT_SIZE = 2;    // Candidates per tournament (k)
 int nQ = 0, nR = 0, nB = 0, nK = 0; // Piece counts
+int MIGRATION_INTERVAL = 10;    // Generations between island migrations (M)
+int MIGRANTS = 2;               // Individuals each island sends per migration (k)
 #define  PC  0.8  // Crossover probability
 #define  PM  0.1  // Mutation probability
 
@@ -14,6 +34,540 @@ int nQ = 0, nR = 0, nB = 0, nK = 0; // Piece counts
 #define  ROWS  4
 #define  COLS  4
 
+// Chromosomes store one PieceType per cell so attack tests can index tables
+// directly; pieceSymbol maps a type back to its letter for printing
+enum PieceType { EMPTY = 0, QUEEN, ROOK, BISHOP, KNIGHT, PIECE_TYPES };
+const char pieceSymbol[PIECE_TYPES + 1] = "EQRBK";
+
+char pieceTypeOf(char symbol) {
+    switch (symbol) {
+        case 'Q': return QUEEN;
+        case 'R': return ROOK;
+        case 'B': return BISHOP;
+        case 'K': return KNIGHT;
+    }
+    return EMPTY;
+}
+
+// ---- Packed chromosomes ----
+// A chromosome is one 64-bit word: cell i holds its PieceType in bits
+// 4i..4i+3, so 16 cells fill the word exactly. Copy, equality and crossover
+// are single-word operations, and cellsOf() turns a piece type into a
+// 16-bit bitboard with a few shifts instead of a loop over cells.
+typedef unsigned long long Genome;
+
+#define CELL_BITS     4
+#define CELL_MASK     0xFULL
+#define NIBBLE_LOW    0x1111111111111111ULL
+#define NIBBLE_HIGH   0x8888888888888888ULL
+
+static inline int getCell(Genome g, int i) {
+    return (int)((g >> (CELL_BITS * i)) & CELL_MASK);
+}
+
+static inline Genome setCell(Genome g, int i, int type) {
+    int shift = CELL_BITS * i;
+    return (g & ~(CELL_MASK << shift)) | ((Genome)type << shift);
+}
+
+// Exchange the contents of two cells
+static inline Genome swapGenomeCells(Genome g, int a, int b) {
+    Genome diff = (Genome)(getCell(g, a) ^ getCell(g, b));
+    return g ^ (diff << (CELL_BITS * a)) ^ (diff << (CELL_BITS * b));
+}
+
+// Gather bit 0 of every nibble into a 16-bit mask (cell i -> bit i)
+static inline unsigned short gatherNibbles(Genome x) {
+    x &= NIBBLE_LOW;
+    x = (x | (x >> 3)) & 0x0303030303030303ULL;
+    x = (x | (x >> 6)) & 0x000F000F000F000FULL;
+    x = (x | (x >> 12)) & 0x000000FF000000FFULL;
+    return (unsigned short)(x | (x >> 24));
+}
+
+// Inverse of gatherNibbles: bit i of the mask fills all four bits of cell i
+static inline Genome scatterNibbles(unsigned short mask) {
+    Genome x = mask;
+    x = (x | (x << 24)) & 0x000000FF000000FFULL;
+    x = (x | (x << 12)) & 0x000F000F000F000FULL;
+    x = (x | (x << 6)) & 0x0303030303030303ULL;
+    x = (x | (x << 3)) & NIBBLE_LOW;
+    return x * CELL_MASK;
+}
+
+// Cells 0..n-1 of a genome
+static inline Genome cellPrefix(int n) {
+    return n >= SIZE ? ~0ULL : (1ULL << (CELL_BITS * n)) - 1;
+}
+
+// Bitboard of the cells that are not EMPTY
+static inline unsigned short occupiedCells(Genome g) {
+    Genome nonZero = (((g & ~NIBBLE_HIGH) + ~NIBBLE_HIGH) | g) & NIBBLE_HIGH;
+    return gatherNibbles(nonZero >> 3);
+}
+
+// Bitboard of the cells holding the given piece type
+static inline unsigned short cellsOf(Genome g, int type) {
+    Genome x = g ^ (NIBBLE_LOW * (Genome)type);   // Zero nibble where the cell matches
+    Genome nonZero = (((x & ~NIBBLE_HIGH) + ~NIBBLE_HIGH) | x) & NIBBLE_HIGH;
+    return gatherNibbles(~nonZero >> 3);
+}
+
+Genome packChromosome(const char chrom[]) {
+    Genome g = 0;
+    for (int i = 0; i < SIZE; i++) g |= (Genome)chrom[i] << (CELL_BITS * i);
+    return g;
+}
+
+// ---- Thread pool ----
+// Workers that stay parked between generations and split one job at a time.
+// A job is a range of items cut into chunks; each worker starts with its own
+// contiguous share of the chunks in a queue, takes them from the front, and
+// once it runs dry steals from the back of the other queues. A queue is a
+// single word holding [head, tail) of chunk indices, so owner and thieves
+// claim chunks with one compare-and-swap and never take a lock. poolRun
+// returns only after every chunk is finished, which is the barrier before
+// the serial steps that follow. On Windows the caller runs every chunk.
+
+#define CHUNKS_PER_WORKER 8   // Chunks queued per worker, for stealing slack
+#define MIN_CHUNK 64          // Items per chunk at least (always even)
+
+typedef void (*TaskFn)(void *context, int begin, int end);
+
+typedef struct {
+    _Alignas(ARENA_ALIGN) uint64_t range;   // head in the low word, tail in the high word
+} WorkQueue;
+
+typedef struct ThreadPool ThreadPool;
+
+typedef struct {
+    ThreadPool *pool;
+    int id;
+} Worker;
+
+struct ThreadPool {
+    int workers;                // Threads taking chunks, the caller included
+    WorkQueue *queues;          // One per worker
+    TaskFn task;                // Current job
+    void *context;
+    int total;
+    int chunkSize;
+#ifndef _WIN32
+    pthread_t *threads;
+    Worker *slots;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned long epoch;        // Bumped for every job
+    int running;                // Workers still inside the current job
+    int stop;
+#endif
+};
+
+// Claim one chunk from the front (owner) or the back (thief); -1 when empty
+static inline int takeChunk(WorkQueue *queue, int fromBack) {
+    uint64_t range = __atomic_load_n(&queue->range, __ATOMIC_ACQUIRE);
+    
+    for (;;) {
+        uint32_t head = (uint32_t)range;
+        uint32_t tail = (uint32_t)(range >> 32);
+        if (head >= tail) return -1;
+        
+        uint64_t next = fromBack ? ((uint64_t)(tail - 1) << 32) | head
+                                 : ((uint64_t)tail << 32) | (head + 1);
+        if (__atomic_compare_exchange_n(&queue->range, &range, next, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return (int)(fromBack ? tail - 1 : head);
+    }
+}
+
+// Run chunks until no queue has any left
+void workChunks(ThreadPool *pool, int id) {
+    for (;;) {
+        int chunk = takeChunk(&pool->queues[id], 0);
+        for (int v = 1; chunk < 0 && v < pool->workers; v++) {
+            chunk = takeChunk(&pool->queues[(id + v) % pool->workers], 1);
+        }
+        if (chunk < 0) return;
+        
+        int begin = chunk * pool->chunkSize;
+        int end = begin + pool->chunkSize < pool->total ? begin + pool->chunkSize : pool->total;
+        pool->task(pool->context, begin, end);
+    }
+}
+
+#ifndef _WIN32
+void *workerMain(void *arg) {
+    Worker *self = arg;
+    ThreadPool *pool = self->pool;
+    unsigned long seen = 0;
+    
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->epoch == seen && !pool->stop) pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->stop) break;
+        seen = pool->epoch;
+        pthread_mutex_unlock(&pool->lock);
+        
+        workChunks(pool, self->id);
+        
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+#endif
+
+// Start workers - 1 threads (0 means one per online core); the caller is
+// the last worker. Returns 0 when the pool cannot be set up.
+int poolStart(ThreadPool *pool, int workers) {
+#ifdef _WIN32
+    workers = 1;
+#else
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (workers < 1) workers = 1;
+    
+    pool->workers = workers;
+    pool->queues = aligned_alloc(ARENA_ALIGN, workers * sizeof *pool->queues);
+    if (!pool->queues) return 0;
+    
+#ifndef _WIN32
+    pool->threads = malloc(workers * sizeof *pool->threads);
+    pool->slots = malloc(workers * sizeof *pool->slots);
+    if (!pool->threads || !pool->slots) return 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->epoch = 0;
+    pool->running = 0;
+    pool->stop = 0;
+    
+    for (int w = 1; w < workers; w++) {
+        pool->slots[w].pool = pool;
+        pool->slots[w].id = w;
+        if (pthread_create(&pool->threads[w], NULL, workerMain, &pool->slots[w]) != 0) {
+            // Run with the threads that did start
+            pool->workers = w;
+            break;
+        }
+    }
+#endif
+    return 1;
+}
+
+void poolStop(ThreadPool *pool) {
+#ifndef _WIN32
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int w = 1; w < pool->workers; w++) pthread_join(pool->threads[w], NULL);
+    
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+    free(pool->threads);
+    free(pool->slots);
+#endif
+    free(pool->queues);
+}
+
+// task(context, begin, end) over [0, total) in chunks; returns once all are done
+void poolRun(ThreadPool *pool, TaskFn task, void *context, int total) {
+    int chunkSize = total / (pool->workers * CHUNKS_PER_WORKER);
+    if (chunkSize < MIN_CHUNK) chunkSize = MIN_CHUNK;
+    chunkSize += chunkSize & 1;
+    int chunks = (total + chunkSize - 1) / chunkSize;
+    
+    pool->task = task;
+    pool->context = context;
+    pool->total = total;
+    pool->chunkSize = chunkSize;
+    for (int w = 0; w < pool->workers; w++) {
+        uint64_t head = (uint64_t)chunks * w / pool->workers;
+        uint64_t tail = (uint64_t)chunks * (w + 1) / pool->workers;
+        pool->queues[w].range = (tail << 32) | head;
+    }
+    
+#ifndef _WIN32
+    if (pool->workers > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->running = pool->workers - 1;
+        pool->epoch++;
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+        
+        workChunks(pool, 0);
+        
+        pthread_mutex_lock(&pool->lock);
+        while (pool->running > 0) pthread_cond_wait(&pool->done, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+#endif
+    workChunks(pool, 0);
+}
+
+// ---- Random numbers ----
+// xoshiro256++ streams owned by the caller and passed to every operator, so
+// there is no hidden global state to lock or share between threads. Single
+// draws come from the scalar stream. The bulk fills step four more streams
+// in lockstep: the AVX2 kernel advances all four in one vector, and the
+// scalar kernel produces the identical sequence, so a seed gives the same
+// run on every CPU.
+//
+// Streams are never carried from one piece of work to the next. Each one is
+// keyed by (seed, generation, individual, operator) and its state is one
+// Philox4x64-10 block of that counter, so an individual's draws do not
+// depend on how many others were processed before it, in which order, or
+// on which thread.
+typedef struct {
+    uint64_t s[4];          // Scalar stream
+    uint64_t lane[4][4];    // Bulk streams, lane[word][stream]
+} Rng;
+
+// Operator field of a stream key
+enum StreamOperator { STREAM_INIT, STREAM_SELECTION, STREAM_CROSSOVER, STREAM_MUTATION, STREAM_REPAIR,
+                      STREAM_ISLAND };
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t mulHiLo(uint64_t a, uint64_t b, uint64_t *hi) {
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *hi = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+}
+
+// Philox4x64-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"):
+// a keyed bijection of a 256-bit counter. Counter {0,0,0,0} with key {0,0}
+// gives 16554d9eca36314c db20fe9d672d0fdc d7e772cee186176b 7e68b68aec7ba23b.
+void philox4x64(const uint64_t counter[4], const uint64_t key[2], uint64_t out[4]) {
+    uint64_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+    uint64_t k0 = key[0], k1 = key[1];
+    
+    for (int round = 0; round < 10; round++) {
+        uint64_t hi0, hi1;
+        uint64_t lo0 = mulHiLo(0xD2E7470EE14C6C93ULL, x0, &hi0);
+        uint64_t lo1 = mulHiLo(0xCA5A826395121157ULL, x2, &hi1);
+        x0 = hi1 ^ x1 ^ k0;
+        x1 = lo1;
+        x2 = hi0 ^ x3 ^ k1;
+        x3 = lo0;
+        k0 += 0x9E3779B97F4A7C15ULL;
+        k1 += 0xBB67AE8584CAA73BULL;
+    }
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+}
+
+// Stream for one (generation, individual, operator) of the run with this
+// seed. The scalar state is the Philox block itself; the bulk streams are
+// expanded from it with splitmix64 rather than costing four more blocks.
+void rngKeyed(Rng *rng, uint64_t seed, int generation, int individual, int op) {
+    const uint64_t counter[4] = {(uint64_t)generation, (uint64_t)individual, (uint64_t)op, 0};
+    const uint64_t key[2] = {seed, 0};
+    philox4x64(counter, key, rng->s);
+    
+    uint64_t chain = rng->s[0] ^ rotl64(rng->s[3], 32);
+    for (int w = 0; w < 4; w++)
+        for (int l = 0; l < 4; l++) rng->lane[w][l] = splitmix64(&chain);
+}
+
+static inline uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl64(s[0] + s[3], 23) + s[0];
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+// Uniform integer in [0, n) without modulo bias (Lemire's multiply-shift:
+// the high half of x * n is the result, and the rare draws whose low half
+// falls under 2^32 mod n are rejected)
+static inline int rngBounded(Rng *rng, int n) {
+    uint64_t m = (rngNext(rng) >> 32) * (uint32_t)n;
+    uint32_t low = (uint32_t)m;
+    if (low < (uint32_t)n) {
+        uint32_t threshold = -(uint32_t)n % (uint32_t)n;
+        while (low < threshold) {
+            m = (rngNext(rng) >> 32) * (uint32_t)n;
+            low = (uint32_t)m;
+        }
+    }
+    return (int)(m >> 32);
+}
+
+// Uniform double in [0, 1) with 53 random bits
+static inline double rngUnit(Rng *rng) {
+    return (rngNext(rng) >> 11) * 0x1.0p-53;
+}
+
+typedef void (*RngFillFn)(uint64_t lane[4][4], uint64_t out[], int groups);
+
+// One xoshiro256++ step of all four bulk streams per group of four words
+void rngFillScalar(uint64_t lane[4][4], uint64_t out[], int groups) {
+    for (int g = 0; g < groups; g++) {
+        for (int l = 0; l < 4; l++) {
+            out[4 * g + l] = rotl64(lane[0][l] + lane[3][l], 23) + lane[0][l];
+            uint64_t t = lane[1][l] << 17;
+            lane[2][l] ^= lane[0][l];
+            lane[3][l] ^= lane[1][l];
+            lane[1][l] ^= lane[2][l];
+            lane[0][l] ^= lane[3][l];
+            lane[2][l] ^= t;
+            lane[3][l] = rotl64(lane[3][l], 45);
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define ROTL256(x, k) _mm256_or_si256(_mm256_slli_epi64((x), (k)), _mm256_srli_epi64((x), 64 - (k)))
+
+__attribute__((target("avx2")))
+void rngFillAVX2(uint64_t lane[4][4], uint64_t out[], int groups) {
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)lane[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)lane[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i *)lane[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i *)lane[3]);
+    
+    for (int g = 0; g < groups; g++) {
+        __m256i result = _mm256_add_epi64(ROTL256(_mm256_add_epi64(s0, s3), 23), s0);
+        _mm256_storeu_si256((__m256i *)(out + 4 * g), result);
+        __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = ROTL256(s3, 45);
+    }
+    
+    _mm256_storeu_si256((__m256i *)lane[0], s0);
+    _mm256_storeu_si256((__m256i *)lane[1], s1);
+    _mm256_storeu_si256((__m256i *)lane[2], s2);
+    _mm256_storeu_si256((__m256i *)lane[3], s3);
+}
+
+#endif
+
+RngFillFn selectRngKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return rngFillAVX2;
+#endif
+    return rngFillScalar;
+}
+
+// count raw 64-bit words from the bulk streams. Words are produced four at
+// a time; a partial last group is drawn in full and the spare words dropped.
+void rngFill(Rng *rng, uint64_t out[], int count) {
+    // Cached on first use; racing threads store the same pointer
+    static RngFillFn cached = NULL;
+    RngFillFn fill = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    if (!fill) {
+        fill = selectRngKernel();
+        __atomic_store_n(&cached, fill, __ATOMIC_RELAXED);
+    }
+    
+    fill(rng->lane, out, count / 4);
+    if (count % 4) {
+        uint64_t spare[4];
+        fill(rng->lane, spare, 1);
+        for (int i = 0; i < count % 4; i++) out[count - count % 4 + i] = spare[i];
+    }
+}
+
+// count doubles in [0, 1), each with 53 random bits
+void rngFillUnit(Rng *rng, double out[], int count) {
+    uint64_t words[64];
+    
+    for (int base = 0; base < count; base += 64) {
+        int chunk = count - base < 64 ? count - base : 64;
+        rngFill(rng, words, chunk);
+        for (int i = 0; i < chunk; i++) out[base + i] = (words[i] >> 11) * 0x1.0p-53;
+    }
+}
+
+// count integers in [0, n); rejected draws are redrawn from the scalar stream
+void rngFillBounded(Rng *rng, int out[], int count, int n) {
+    uint64_t words[64];
+    uint32_t threshold = -(uint32_t)n % (uint32_t)n;
+    
+    for (int base = 0; base < count; base += 64) {
+        int chunk = count - base < 64 ? count - base : 64;
+        rngFill(rng, words, chunk);
+        for (int i = 0; i < chunk; i++) {
+            uint64_t m = (words[i] >> 32) * (uint32_t)n;
+            while ((uint32_t)m < threshold) m = (rngNext(rng) >> 32) * (uint32_t)n;
+            out[base + i] = (int)(m >> 32);
+        }
+    }
+}
+
+// ---- Population store ----
+// Structure-of-arrays layout: genomes, fitness values and score components
+// each sit in their own contiguous column, so selection and sorting touch
+// only the fitness column. evolutionLoop keeps two of these and swaps them
+// between generations instead of copying individuals back.
+typedef struct {
+    unsigned char threatened;   // Threatened pieces
+    unsigned char penalty;      // Columns holding more than one queen
+} Components;
+
+typedef struct {
+    Genome *genome;
+    double *fitness;
+    Components *components;
+    int size;
+} Population;
+
+// Carve the columns out of arena; returns 0 when it is exhausted
+int allocPopulation(Population *pop, int size, Arena *arena) {
+    pop->genome = arenaAlloc(arena, size * sizeof *pop->genome);
+    pop->fitness = arenaAlloc(arena, size * sizeof *pop->fitness);
+    pop->components = arenaAlloc(arena, size * sizeof *pop->components);
+    pop->size = size;
+    return pop->genome && pop->fitness && pop->components;
+}
+
+size_t populationBytes(int size) {
+    return arenaBytes(size * sizeof(Genome)) +
+           arenaBytes(size * sizeof(double)) +
+           arenaBytes(size * sizeof(Components));
+}
+
+// Copy individual s of src into slot d of dst
+static inline void copyIndividual(Population *dst, int d, const Population *src, int s) {
+    dst->genome[d] = src->genome[s];
+    dst->fitness[d] = src->fitness[s];
+    dst->components[d] = src->components[s];
+}
+
+static inline void swapPopulations(Population *a, Population *b) {
+    Population temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
 void printBoard(char board[ROWS][COLS]) {
     printf("\nBoard (4x4):\n");
     for (int r = 0; r < ROWS; r++) {
@@ -42,404 +596,1819 @@ void readPosition(char piece, int number, char board[ROWS][COLS]) {
     }
 }
 
+// Attack bitboards: bit j of attackTable[type][i] is set when a piece of that
+// type on square i threatens square j, i.e. a [type][from][to] table packed
+// into one word per square. The EMPTY row stays zero, so every cell can be
+// looked up without testing what it holds. Built once by initAttackTables().
+unsigned short attackTable[PIECE_TYPES][SIZE];
+unsigned short columnMask[COLS];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+        
+        for (int t = 0; t < PIECE_TYPES; t++) attackTable[t][i] = 0;
+        
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+            
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+            
+            if (r1 == r2 || c1 == c2)
+                attackTable[ROOK][i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                attackTable[BISHOP][i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                attackTable[KNIGHT][i] |= bit;
+        }
+        attackTable[QUEEN][i] = attackTable[ROOK][i] | attackTable[BISHOP][i];
+    }
+    
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
 // Calculate penalty based on queen distribution across columns
-int calculatePenalty(char chrom[]) {
+int calculatePenalty(Genome g) {
+    unsigned short queens = cellsOf(g, QUEEN);
+    
+    // Penalize each column with more than 1 queen
     int penalty = 0;
-    int queensInCol[COLS] = {0};
+    for (int c = 0; c < COLS; c++) {
+        unsigned short inCol = queens & columnMask[c];
+        penalty += (inCol & (inCol - 1)) != 0;
+    }
+    
+    return penalty;
+}
+
+// ---- Blocked (real chess) attacks ----
+// In this mode queens, rooks and bishops stop at the first piece on each ray.
+// The squares whose occupancy can change a slider's reach are its "relevant"
+// mask; the occupied subset of that mask is turned into a table index with
+// PEXT when built with BMI2 (-mbmi2 / -march=native) and with a magic
+// multiply otherwise, so a blocked lookup costs one load per slider.
+int blockedAttacks = 0;
+
+unsigned short rookRelevant[SIZE];
+unsigned short bishopRelevant[SIZE];
+unsigned long long rookMagic[SIZE];
+unsigned long long bishopMagic[SIZE];
+int rookShift[SIZE];
+int bishopShift[SIZE];
+unsigned short rookTable[SIZE][16];     // Relevant masks have at most 4 bits on 4x4
+unsigned short bishopTable[SIZE][16];
+
+const int rookDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+const int bishopDirs[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Walk each ray from sq, stopping on (and including) the first occupied square
+unsigned short slideAttacks(int sq, unsigned short occupied, const int dirs[4][2]) {
+    unsigned short attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        int r = sq / COLS + dirs[d][0];
+        int c = sq % COLS + dirs[d][1];
+        while (r >= 0 && r < ROWS && c >= 0 && c < COLS) {
+            unsigned short bit = (unsigned short)(1 << (r * COLS + c));
+            attacks |= bit;
+            if (occupied & bit) break;
+            r += dirs[d][0];
+            c += dirs[d][1];
+        }
+    }
+    return attacks;
+}
+
+// Ray squares that have another square behind them
+unsigned short relevantMask(int sq, const int dirs[4][2]) {
+    unsigned short mask = 0;
+    for (int d = 0; d < 4; d++) {
+        int r = sq / COLS + dirs[d][0];
+        int c = sq % COLS + dirs[d][1];
+        while (r + dirs[d][0] >= 0 && r + dirs[d][0] < ROWS &&
+               c + dirs[d][1] >= 0 && c + dirs[d][1] < COLS) {
+            mask |= (unsigned short)(1 << (r * COLS + c));
+            r += dirs[d][0];
+            c += dirs[d][1];
+        }
+    }
+    return mask;
+}
+
+static inline unsigned int sliderIndex(unsigned short occupied, unsigned short relevant,
+                                       unsigned long long magic, int shift) {
+#if defined(__BMI2__)
+    (void)magic;
+    (void)shift;
+    return _pext_u32(occupied, relevant);
+#else
+    return (unsigned int)(((unsigned long long)(occupied & relevant) * magic) >> shift);
+#endif
+}
+
+// Fill one slider's lookup table; returns 0 if the magic causes a collision
+int fillSliderTable(int sq, const int dirs[4][2], unsigned short relevant,
+                    unsigned long long magic, int shift, unsigned short table[16]) {
+    int used[16] = {0};
+    
+    // Enumerate every subset of the relevant mask (carry-rippler)
+    unsigned short subset = 0;
+    do {
+        unsigned int idx = sliderIndex(subset, relevant, magic, shift);
+        unsigned short attacks = slideAttacks(sq, subset, dirs);
+        if (used[idx] && table[idx] != attacks) return 0;
+        used[idx] = 1;
+        table[idx] = attacks;
+        subset = (unsigned short)((subset - relevant) & relevant);
+    } while (subset);
+    
+    return 1;
+}
+
+// Find a collision-free magic for one square (unused when PEXT is available)
+void initSlider(int sq, const int dirs[4][2], unsigned short *relevant,
+                unsigned long long *magic, int *shift, unsigned short table[16]) {
+    *relevant = relevantMask(sq, dirs);
+    int bits = __builtin_popcount(*relevant);
+    *shift = 64 - (bits > 0 ? bits : 1);
+    
+    // Local xorshift so the search does not disturb the GA's random streams
+    static unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+    do {
+        unsigned long long candidate = ~0ULL;
+        for (int k = 0; k < 3; k++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            candidate &= seed;
+        }
+        *magic = candidate;
+    } while (!fillSliderTable(sq, dirs, *relevant, *magic, *shift, table));
+}
+
+void initBlockedTables() {
+    for (int sq = 0; sq < SIZE; sq++) {
+        initSlider(sq, rookDirs, &rookRelevant[sq], &rookMagic[sq], &rookShift[sq], rookTable[sq]);
+        initSlider(sq, bishopDirs, &bishopRelevant[sq], &bishopMagic[sq], &bishopShift[sq], bishopTable[sq]);
+    }
+}
+
+static inline unsigned short rookBlocked(int sq, unsigned short occupied) {
+    return rookTable[sq][sliderIndex(occupied, rookRelevant[sq], rookMagic[sq], rookShift[sq])];
+}
+
+static inline unsigned short bishopBlocked(int sq, unsigned short occupied) {
+    return bishopTable[sq][sliderIndex(occupied, bishopRelevant[sq], bishopMagic[sq], bishopShift[sq])];
+}
+
+// Squares a piece of type t on sq reaches when sliders stop at the first piece
+static inline unsigned short blockedAttacksFrom(int sq, int t, unsigned short occupied) {
+    // Which lookups apply to each piece type, as all-ones/all-zero masks
+    static const unsigned short movesLikeRook[PIECE_TYPES]   = {0, 0xFFFF, 0xFFFF, 0, 0};
+    static const unsigned short movesLikeBishop[PIECE_TYPES] = {0, 0xFFFF, 0, 0xFFFF, 0};
+    static const unsigned short movesLikeKnight[PIECE_TYPES] = {0, 0, 0, 0, 0xFFFF};
+    
+    return (rookBlocked(sq, occupied) & movesLikeRook[t]) |
+           (bishopBlocked(sq, occupied) & movesLikeBishop[t]) |
+           (attackTable[KNIGHT][sq] & movesLikeKnight[t]);
+}
+
+// Same as countThreatenedPieces, but sliders are blocked by the first piece
+int countThreatenedBlocked(Genome g, int threatenedPieces[]) {
+    unsigned short occupied = occupiedCells(g);
+    
+    unsigned short attacked = 0;
+    for (unsigned short pieces = occupied; pieces; pieces &= pieces - 1) {
+        int i = __builtin_ctz(pieces);
+        attacked |= blockedAttacksFrom(i, getCell(g, i), occupied);
+    }
+    
+    unsigned short threatened = attacked & occupied;
+    for (int i = 0; i < SIZE; i++) {
+        threatenedPieces[i] = (threatened >> i) & 1;
+    }
+    
+    return __builtin_popcount(threatened);
+}
+
+// Counts number of threatened pieces (not number of threats)
+int countThreatenedPieces(Genome g, int threatenedPieces[]) {
+    if (blockedAttacks) return countThreatenedBlocked(g, threatenedPieces);
+    
+    unsigned short occupied = occupiedCells(g);
+    unsigned short attacked = 0;
+    
+    // OR together the attack set of every piece on the board
+    for (unsigned short pieces = occupied; pieces; pieces &= pieces - 1) {
+        int i = __builtin_ctz(pieces);
+        attacked |= attackTable[getCell(g, i)][i];
+    }
+    
+    // A piece is threatened when its square is attacked by any other piece
+    unsigned short threatened = attacked & occupied;
+    for (int i = 0; i < SIZE; i++) {
+        threatenedPieces[i] = (threatened >> i) & 1;
+    }
+    
+    return __builtin_popcount(threatened);
+}
+
+// Counts attacking pairs (a piece attacking two others counts twice), the
+// Conflicts() measure of tp.c / tp2.c
+int countAttackingPairs(Genome g) {
+    unsigned short occupied = occupiedCells(g);
+    
+    int pairs = 0;
+    for (unsigned short pieces = occupied; pieces; pieces &= pieces - 1) {
+        int i = __builtin_ctz(pieces);
+        unsigned short attacks = blockedAttacks ? blockedAttacksFrom(i, getCell(g, i), occupied)
+                                                : attackTable[getCell(g, i)][i];
+        pairs += __builtin_popcount(attacks & occupied);
+    }
+    
+    return pairs;
+}
+
+// ---- Fitness strategies ----
+// Each objective is 1 / (1 + score) for an integer score built from the
+// board. A strategy supplies a full hook (strategyScore, from a chromosome)
+// and an incremental hook (strategyStateScore, from a ThreatState). Both take
+// the strategy as a parameter and are forced inline; the population-wide
+// loops switch on fitnessStrategy once and then run a copy of the loop
+// specialised for that strategy, so nothing is dispatched per chromosome.
+enum FitnessStrategy {
+    FIT_THREATENED_PENALTY = 0,   // td2.c / ted.c
+    FIT_THREATENED,               // tg2.c without the queen-column term
+    FIT_ATTACK_PAIRS,             // Conflicts() in tp.c / tp2.c
+    FIT_STRATEGIES
+};
+
+typedef struct {
+    const char *name;
+    const char *formula;
+} FitnessStrategyInfo;
+
+const FitnessStrategyInfo fitnessStrategies[FIT_STRATEGIES] = {
+    {"threatened+penalty", "1 / (1 + threatened pieces + queen-column penalty)"},
+    {"threatened",         "1 / (1 + threatened pieces)"},
+    {"pairs",              "1 / (1 + attacking pairs)"},
+};
+
+int fitnessStrategy = FIT_THREATENED_PENALTY;
+
+// Also fills parts, so callers get the reported components for free
+__attribute__((always_inline))
+static inline int strategyScore(int strategy, Genome g, Components *parts) {
+    int threatenedPieces[SIZE];
+    parts->threatened = (unsigned char)countThreatenedPieces(g, threatenedPieces);
+    parts->penalty = (unsigned char)calculatePenalty(g);
+    switch (strategy) {
+        case FIT_THREATENED: return parts->threatened;
+        case FIT_ATTACK_PAIRS: return countAttackingPairs(g);
+    }
+    return parts->threatened + parts->penalty;
+}
+
+// ---- Exhaustive 4x4 lookup table ----
+// fitgen.c scores every placement for one piece mix and writes it to
+// fitness_<nQ>_<nR>_<nB>_<nK>.tbl. When that file exists it is memory-mapped
+// and evaluatePopulation scores a placement with a single load at its rank.
+
+typedef struct {
+    char magic[4];                // "FTB1"
+    unsigned char counts[4];      // nQ, nR, nB, nK
+    unsigned long long entries;   // number of placements that follow
+} TableHeader;
+
+#define NO_RANK (~0ULL)
+
+unsigned long long binom[SIZE + 1][SIZE + 1];
+const unsigned char *fitnessTable = NULL;   // NULL when no table is loaded
+unsigned long long fitnessTableEntries = 0;
+double fitnessOfScore[2 * SIZE + 1];        // 1 / (1 + score) for every table byte
+
+// Rank of a placement in the combinatorial number system: queens are ranked
+// among all cells, rooks among the cells left after queens, and so on; the
+// four ranks are then combined as a mixed-radix number. Must match fitgen.c.
+unsigned long long rankPlacement(Genome g) {
+    int counts[4] = {nQ, nR, nB, nK};
+    int seen[4] = {0};
+    int level[4] = {0};   // Index of the current cell among cells free at each level
+    unsigned long long part[4] = {0};
+    
+    static const int rankLevel[PIECE_TYPES] = {4, 0, 1, 2, 3};
     
-    // Count queens in each column
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'Q') {
-            int col = i % COLS;
-            queensInCol[col]++;
+        int t = rankLevel[getCell(g, i)];
+        for (int l = 0; l <= t && l < 4; l++) {
+            if (l == t) part[t] += binom[level[t]][++seen[t]];
+            level[l]++;
         }
     }
     
-    // Penalize columns with more than 1 queen
+    for (int t = 0; t < 4; t++)
+        if (seen[t] != counts[t]) return NO_RANK;
+    
+    unsigned long long rank = 0;
+    int freeCells = SIZE;
+    for (int t = 0; t < 4; t++) {
+        rank = rank * binom[freeCells][counts[t]] + part[t];
+        freeCells -= counts[t];
+    }
+    return rank;
+}
+
+// Map the table for the current piece counts; returns 1 on success
+int loadFitnessTable() {
+    for (int n = 0; n <= SIZE; n++) {
+        binom[n][0] = 1;
+        for (int k = 1; k <= SIZE; k++)
+            binom[n][k] = (n == 0) ? 0 : binom[n - 1][k - 1] + binom[n - 1][k];
+    }
+    for (int s = 0; s <= 2 * SIZE; s++)
+        fitnessOfScore[s] = 1.0 / (1.0 + s);
+    
+    char filename[64];
+    sprintf(filename, "fitness_%d_%d_%d_%d.tbl", nQ, nR, nB, nK);
+    
+    unsigned long long expected = 1;
+    int counts[4] = {nQ, nR, nB, nK};
+    int freeCells = SIZE;
+    for (int t = 0; t < 4; t++) {
+        expected *= binom[freeCells][counts[t]];
+        freeCells -= counts[t];
+    }
+    
+#ifdef _WIN32
+    FILE *in = fopen(filename, "rb");
+    if (!in) return 0;
+    fseek(in, 0, SEEK_END);
+    long fileSize = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (fileSize < (long)sizeof(TableHeader)) {
+        fclose(in);
+        return 0;
+    }
+    unsigned char *base = malloc(fileSize);
+    if (!base || fread(base, 1, fileSize, in) != (size_t)fileSize) {
+        free(base);
+        fclose(in);
+        return 0;
+    }
+    fclose(in);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(TableHeader)) {
+        close(fd);
+        return 0;
+    }
+    long fileSize = (long)st.st_size;
+    unsigned char *base = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+#endif
+    
+    const TableHeader *header = (const TableHeader *)base;
+    int valid = memcmp(header->magic, "FTB1", 4) == 0 &&
+                header->entries == expected &&
+                (unsigned long long)fileSize == sizeof(TableHeader) + expected;
+    for (int t = 0; t < 4; t++)
+        if (header->counts[t] != counts[t]) valid = 0;
+    
+    if (!valid) {
+        printf("Ignoring %s: header does not match Q=%d, R=%d, B=%d, K=%d\n",
+               filename, nQ, nR, nB, nK);
+#ifdef _WIN32
+        free(base);
+#else
+        munmap(base, fileSize);
+#endif
+        return 0;
+    }
+    
+    fitnessTable = base + sizeof(TableHeader);
+    fitnessTableEntries = expected;
+    printf("Loaded fitness table %s (%llu entries)\n", filename, expected);
+    return 1;
+}
+
+// ---- Batched population scoring ----
+// Boards are transposed into one 16-bit bitboard per piece type so that a
+// single vector instruction works on 16 (AVX2) or 8 (SSE4.1) boards at once.
+// The kernel is picked once via CPUID; every path returns exactly the same
+// values as the scalar strategyScore path.
+
+#define BATCH 16
+
+// Pack up to BATCH chromosomes into per-piece bitboards
+void packBatch(Genome population[], int count,
+               unsigned short q[], unsigned short r[],
+               unsigned short b[], unsigned short k[])
+{
+    for (int n = 0; n < BATCH; n++) {
+        Genome g = n < count ? population[n] : 0;
+        q[n] = cellsOf(g, QUEEN);
+        r[n] = cellsOf(g, ROOK);
+        b[n] = cellsOf(g, BISHOP);
+        k[n] = cellsOf(g, KNIGHT);
+    }
+}
+
+// Scalar kernel: threatened pieces and penalty for each packed board
+void scoreBatchScalar(const unsigned short q[], const unsigned short r[],
+                      const unsigned short b[], const unsigned short k[],
+                      unsigned short threatened[], unsigned short penalty[])
+{
+    for (int n = 0; n < BATCH; n++) {
+        unsigned short attacked = 0;
+        for (int s = 0; s < SIZE; s++) {
+            unsigned short bit = (unsigned short)(1 << s);
+            if (q[n] & bit) attacked |= attackTable[QUEEN][s];
+            if (r[n] & bit) attacked |= attackTable[ROOK][s];
+            if (b[n] & bit) attacked |= attackTable[BISHOP][s];
+            if (k[n] & bit) attacked |= attackTable[KNIGHT][s];
+        }
+        unsigned short occupied = q[n] | r[n] | b[n] | k[n];
+        int columns = 0;
+        for (int c = 0; c < COLS; c++) {
+            unsigned short inCol = q[n] & columnMask[c];
+            columns += (inCol & (inCol - 1)) != 0;
+        }
+        threatened[n] = (unsigned short)__builtin_popcount(attacked & occupied);
+        penalty[n] = (unsigned short)columns;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Per-lane popcount of 16-bit words using a nibble lookup (pshufb)
+__attribute__((target("avx2")))
+static __m256i popcount16x16(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low4));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+    __m256i bytes = _mm256_add_epi8(lo, hi);
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)),
+                            _mm256_srli_epi16(bytes, 8));
+}
+
+// AVX2 kernel: 16 boards per instruction
+__attribute__((target("avx2")))
+void scoreBatchAVX2(const unsigned short q[], const unsigned short r[],
+                    const unsigned short b[], const unsigned short k[],
+                    unsigned short threatened[], unsigned short penalty[])
+{
+    __m256i vq = _mm256_loadu_si256((const __m256i *)q);
+    __m256i vr = _mm256_loadu_si256((const __m256i *)r);
+    __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+    __m256i vk = _mm256_loadu_si256((const __m256i *)k);
+    __m256i attacked = _mm256_setzero_si256();
+    
+    for (int s = 0; s < SIZE; s++) {
+        __m256i bit = _mm256_set1_epi16((short)(1 << s));
+        __m256i onQ = _mm256_cmpeq_epi16(_mm256_and_si256(vq, bit), bit);
+        __m256i onR = _mm256_cmpeq_epi16(_mm256_and_si256(vr, bit), bit);
+        __m256i onB = _mm256_cmpeq_epi16(_mm256_and_si256(vb, bit), bit);
+        __m256i onK = _mm256_cmpeq_epi16(_mm256_and_si256(vk, bit), bit);
+        attacked = _mm256_or_si256(attacked, _mm256_and_si256(onQ, _mm256_set1_epi16((short)attackTable[QUEEN][s])));
+        attacked = _mm256_or_si256(attacked, _mm256_and_si256(onR, _mm256_set1_epi16((short)attackTable[ROOK][s])));
+        attacked = _mm256_or_si256(attacked, _mm256_and_si256(onB, _mm256_set1_epi16((short)attackTable[BISHOP][s])));
+        attacked = _mm256_or_si256(attacked, _mm256_and_si256(onK, _mm256_set1_epi16((short)attackTable[KNIGHT][s])));
+    }
+    
+    __m256i occupied = _mm256_or_si256(_mm256_or_si256(vq, vr), _mm256_or_si256(vb, vk));
+    __m256i count = popcount16x16(_mm256_and_si256(attacked, occupied));
+    
+    // Column has 2+ queens when clearing its lowest queen leaves a non-zero mask
+    const __m256i one = _mm256_set1_epi16(1);
+    __m256i columns = _mm256_setzero_si256();
     for (int c = 0; c < COLS; c++) {
-        if (queensInCol[c] > 1) {
-            penalty++; // Penalize each column with more than 1 queen
+        __m256i inCol = _mm256_and_si256(vq, _mm256_set1_epi16((short)columnMask[c]));
+        __m256i rest = _mm256_and_si256(inCol, _mm256_sub_epi16(inCol, one));
+        __m256i isZero = _mm256_cmpeq_epi16(rest, _mm256_setzero_si256());
+        columns = _mm256_add_epi16(columns, _mm256_add_epi16(one, isZero));
+    }
+    
+    _mm256_storeu_si256((__m256i *)threatened, count);
+    _mm256_storeu_si256((__m256i *)penalty, columns);
+}
+
+// SSE4.1 kernel: 8 boards per instruction, two passes per batch
+__attribute__((target("sse4.1")))
+void scoreBatchSSE4(const unsigned short q[], const unsigned short r[],
+                    const unsigned short b[], const unsigned short k[],
+                    unsigned short threatened[], unsigned short penalty[])
+{
+    const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low4 = _mm_set1_epi8(0x0F);
+    const __m128i one = _mm_set1_epi16(1);
+    
+    for (int half = 0; half < BATCH; half += 8) {
+        __m128i vq = _mm_loadu_si128((const __m128i *)(q + half));
+        __m128i vr = _mm_loadu_si128((const __m128i *)(r + half));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + half));
+        __m128i vk = _mm_loadu_si128((const __m128i *)(k + half));
+        __m128i attacked = _mm_setzero_si128();
+        
+        for (int s = 0; s < SIZE; s++) {
+            __m128i bit = _mm_set1_epi16((short)(1 << s));
+            __m128i onQ = _mm_cmpeq_epi16(_mm_and_si128(vq, bit), bit);
+            __m128i onR = _mm_cmpeq_epi16(_mm_and_si128(vr, bit), bit);
+            __m128i onB = _mm_cmpeq_epi16(_mm_and_si128(vb, bit), bit);
+            __m128i onK = _mm_cmpeq_epi16(_mm_and_si128(vk, bit), bit);
+            attacked = _mm_or_si128(attacked, _mm_and_si128(onQ, _mm_set1_epi16((short)attackTable[QUEEN][s])));
+            attacked = _mm_or_si128(attacked, _mm_and_si128(onR, _mm_set1_epi16((short)attackTable[ROOK][s])));
+            attacked = _mm_or_si128(attacked, _mm_and_si128(onB, _mm_set1_epi16((short)attackTable[BISHOP][s])));
+            attacked = _mm_or_si128(attacked, _mm_and_si128(onK, _mm_set1_epi16((short)attackTable[KNIGHT][s])));
         }
+        
+        __m128i occupied = _mm_or_si128(_mm_or_si128(vq, vr), _mm_or_si128(vb, vk));
+        __m128i hit = _mm_and_si128(attacked, occupied);
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(hit, low4));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(hit, 4), low4));
+        __m128i bytes = _mm_add_epi8(lo, hi);
+        __m128i count = _mm_add_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0xFF)),
+                                      _mm_srli_epi16(bytes, 8));
+        
+        __m128i columns = _mm_setzero_si128();
+        for (int c = 0; c < COLS; c++) {
+            __m128i inCol = _mm_and_si128(vq, _mm_set1_epi16((short)columnMask[c]));
+            __m128i rest = _mm_and_si128(inCol, _mm_sub_epi16(inCol, one));
+            __m128i isZero = _mm_cmpeq_epi16(rest, _mm_setzero_si128());
+            columns = _mm_add_epi16(columns, _mm_add_epi16(one, isZero));
+        }
+        
+        _mm_storeu_si128((__m128i *)(threatened + half), count);
+        _mm_storeu_si128((__m128i *)(penalty + half), columns);
     }
+}
+
+#endif
+
+typedef void (*ScoreBatchFn)(const unsigned short[], const unsigned short[],
+                             const unsigned short[], const unsigned short[],
+                             unsigned short[], unsigned short[]);
+
+// Pick the widest kernel this CPU supports
+ScoreBatchFn selectScoreKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return scoreBatchAVX2;
+    if (__builtin_cpu_supports("sse4.1")) return scoreBatchSSE4;
+#endif
+    return scoreBatchScalar;
+}
+
+// Full-evaluation loop specialised for one strategy
+__attribute__((always_inline))
+static inline void evaluateWith(int strategy, Population *pop) {
+    for (int i = 0; i < pop->size; i++)
+        pop->fitness[i] = 1.0 / (1.0 + strategyScore(strategy, pop->genome[i], &pop->components[i]));
+}
+
+// Score every individual of pop in one call
+void evaluatePopulation(Population *pop) {
+    int count = pop->size;
     
-    return penalty;
+    if (fitnessTable) {
+        // The table holds threatened + penalty; split it with the cheap penalty
+        for (int i = 0; i < count; i++) {
+            unsigned long long rank = rankPlacement(pop->genome[i]);
+            if (rank == NO_RANK) {
+                pop->fitness[i] = 1.0 / (1.0 + strategyScore(FIT_THREATENED_PENALTY, pop->genome[i],
+                                                             &pop->components[i]));
+                continue;
+            }
+            int score = fitnessTable[rank];
+            int penalty = calculatePenalty(pop->genome[i]);
+            pop->fitness[i] = fitnessOfScore[score];
+            pop->components[i].threatened = (unsigned char)(score - penalty);
+            pop->components[i].penalty = (unsigned char)penalty;
+        }
+        return;
+    }
+    
+    switch (fitnessStrategy) {
+        case FIT_THREATENED:
+            evaluateWith(FIT_THREATENED, pop);
+            return;
+        case FIT_ATTACK_PAIRS:
+            evaluateWith(FIT_ATTACK_PAIRS, pop);
+            return;
+    }
+    
+    // The vector kernels only know unblocked attacks
+    if (blockedAttacks) {
+        evaluateWith(FIT_THREATENED_PENALTY, pop);
+        return;
+    }
+    
+    // Cached on first use; racing threads store the same pointer
+    static ScoreBatchFn cached = NULL;
+    ScoreBatchFn scoreBatch = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    if (!scoreBatch) {
+        scoreBatch = selectScoreKernel();
+        __atomic_store_n(&cached, scoreBatch, __ATOMIC_RELAXED);
+    }
+    
+    unsigned short q[BATCH], r[BATCH], b[BATCH], k[BATCH];
+    unsigned short threatened[BATCH], penalty[BATCH];
+    
+    for (int base = 0; base < count; base += BATCH) {
+        int n = count - base < BATCH ? count - base : BATCH;
+        packBatch(pop->genome + base, n, q, r, b, k);
+        scoreBatch(q, r, b, k, threatened, penalty);
+        for (int i = 0; i < n; i++) {
+            pop->fitness[base + i] = 1.0 / (1.0 + threatened[i] + penalty[i]);
+            pop->components[base + i].threatened = (unsigned char)threatened[i];
+            pop->components[base + i].penalty = (unsigned char)penalty[i];
+        }
+    }
+}
+
+// Per-chromosome threat counters. They are kept in sync with the board so a
+// swap or a place/remove only updates the attack relations of the touched
+// squares instead of re-scoring the whole chromosome.
+typedef struct {
+    unsigned char attackers[SIZE];   // Number of pieces attacking each square
+    unsigned char queensInCol[COLS];
+    unsigned short occupied;
+    int threatened;                  // Occupied squares with attackers > 0
+    int penalty;                     // Columns holding more than one queen
+    int pairs;                       // Sum of attackers[] over occupied squares
+} ThreatState;
+
+// Put a piece on an empty square
+void placePiece(ThreatState *st, Genome *g, int pos, int piece) {
+    *g = setCell(*g, pos, piece);
+    st->occupied |= (unsigned short)(1 << pos);
+    if (st->attackers[pos]) st->threatened++;
+    
+    unsigned short targets = attackTable[(int)piece][pos];
+    st->pairs += st->attackers[pos] + __builtin_popcount(targets & st->occupied);
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (st->attackers[j]++ == 0 && (st->occupied >> j & 1))
+            st->threatened++;
+    }
+    
+    if (piece == QUEEN && ++st->queensInCol[pos % COLS] == 2)
+        st->penalty++;
+}
+
+// Clear an occupied square
+void removePiece(ThreatState *st, Genome *g, int pos) {
+    int piece = getCell(*g, pos);
+    
+    unsigned short targets = attackTable[piece][pos];
+    st->pairs -= st->attackers[pos] + __builtin_popcount(targets & st->occupied);
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (--st->attackers[j] == 0 && (st->occupied >> j & 1))
+            st->threatened--;
+    }
+    
+    if (st->attackers[pos]) st->threatened--;
+    st->occupied &= (unsigned short)~(1 << pos);
+    *g = setCell(*g, pos, EMPTY);
+    
+    if (piece == QUEEN && st->queensInCol[pos % COLS]-- == 2)
+        st->penalty--;
+}
+
+void initThreatState(ThreatState *st, Genome g) {
+    for (int i = 0; i < SIZE; i++) st->attackers[i] = 0;
+    for (int c = 0; c < COLS; c++) st->queensInCol[c] = 0;
+    st->occupied = 0;
+    st->threatened = 0;
+    st->penalty = 0;
+    st->pairs = 0;
+    
+    // Start from an empty copy and replay every piece onto it
+    Genome board = 0;
+    for (unsigned short pieces = occupiedCells(g); pieces; pieces &= pieces - 1) {
+        int i = __builtin_ctz(pieces);
+        placePiece(st, &board, i, getCell(g, i));
+    }
+}
+
+// Swap two cells, updating only the attack relations of those squares
+void swapCells(ThreatState *st, Genome *g, int a, int b) {
+    int pa = getCell(*g, a);
+    int pb = getCell(*g, b);
+    if (pa == pb) return;
+    
+    if (pa != EMPTY) removePiece(st, g, a);
+    if (pb != EMPTY) removePiece(st, g, b);
+    if (pb != EMPTY) placePiece(st, g, a, pb);
+    if (pa != EMPTY) placePiece(st, g, b, pa);
+}
+
+// Incremental hook: the same scores as strategyScore, read off the counters
+__attribute__((always_inline))
+static inline int strategyStateScore(int strategy, const ThreatState *st) {
+    switch (strategy) {
+        case FIT_THREATENED: return st->threatened;
+        case FIT_ATTACK_PAIRS: return st->pairs;
+    }
+    return st->threatened + st->penalty;
+}
+
+// Incremental-evaluation loop specialised for one strategy
+__attribute__((always_inline))
+static inline void stateScoresWith(int strategy, const ThreatState states[], Population *pop) {
+    for (int i = 0; i < pop->size; i++) {
+        pop->fitness[i] = 1.0 / (1.0 + strategyStateScore(strategy, &states[i]));
+        pop->components[i].threatened = (unsigned char)states[i].threatened;
+        pop->components[i].penalty = (unsigned char)states[i].penalty;
+    }
+}
+
+// Fitness of every individual of pop straight from its counters
+void evaluateStates(const ThreatState states[], Population *pop) {
+    switch (fitnessStrategy) {
+        case FIT_THREATENED:
+            stateScoresWith(FIT_THREATENED, states, pop);
+            return;
+        case FIT_ATTACK_PAIRS:
+            stateScoresWith(FIT_ATTACK_PAIRS, states, pop);
+            return;
+    }
+    stateScoresWith(FIT_THREATENED_PENALTY, states, pop);
+}
+
+Genome shuffle(Genome g, Rng *rng) {
+    for (int i = SIZE - 1; i > 0; i--) {
+        int j = rngBounded(rng, i + 1);
+        g = swapGenomeCells(g, i, j);
+    }
+    return g;
+}
+
+void printGenome(Genome g) {
+    printf("[");
+    for (int i = 0; i < SIZE; i++) {
+        printf("%c", pieceSymbol[getCell(g, i)]);
+        if (i != SIZE - 1) printf(", ");
+    }
+    printf("]");
+}
+
+void printPopulation(const Population *pop, char* label) {
+    printf("\n=== %s ===\n", label);
+    for (int i = 0; i < pop->size; i++) {
+        printf("Chromosome %d: ", i);
+        printGenome(pop->genome[i]);
+        printf(" | Fitness: %.4f", pop->fitness[i]);
+        printf(" | Conflicts: %d | Penalty: %d\n",
+               pop->components[i].threatened, pop->components[i].penalty);
+    }
+}
+
+// ---- Ranking ----
+// Every objective is 1 / (1 + score) for an integer score, so the score is
+// an exact sort key and fitness order is ascending score order. Ranking is a
+// counting sort on that key, O(n + MAX_SCORE) with no comparisons, and the
+// scatter pass only writes the first count positions, so a top-k costs the
+// same single pass. Ties keep population order, as a stable sort would.
+// Attacking pairs is the largest score: each of at most SIZE pieces attacks
+// at most SIZE - 1 others.
+#define MAX_SCORE (SIZE * (SIZE - 1))
+
+static inline int fitnessKey(double fitness) {
+    return (int)(1.0 / fitness - 0.5);
+}
+
+// order[0..count) receives the indices of the count fittest individuals,
+// best first. The keys and counters are released before returning.
+void rankTop(const double fitness[], int n, int order[], int count, Arena *scratch) {
+    size_t mark = arenaMark(scratch);
+    int *key = arenaAlloc(scratch, n * sizeof *key);
+    int *start = arenaAlloc(scratch, (MAX_SCORE + 1) * sizeof *start);
+    memset(start, 0, (MAX_SCORE + 1) * sizeof *start);
+    
+    for (int i = 0; i < n; i++) {
+        key[i] = fitnessKey(fitness[i]);
+        start[key[i]]++;
+    }
+    
+    // Counts become the first position of each key
+    int position = 0;
+    for (int k = 0; k <= MAX_SCORE; k++) {
+        int c = start[k];
+        start[k] = position;
+        position += c;
+    }
+    
+    for (int i = 0; i < n; i++) {
+        int pos = start[key[i]]++;
+        if (pos < count) order[pos] = i;
+    }
+    
+    arenaRewind(scratch, mark);
+}
+
+// Bytes rankTop borrows from scratch for n individuals
+size_t rankBytes(int n) {
+    return arenaBytes(n * sizeof(int)) + arenaBytes((MAX_SCORE + 1) * sizeof(int));
+}
+
+// ---- Tournament selection ----
+// Each tournament draws TOURNAMENT_SIZE distinct candidates with a partial
+// Fisher-Yates shuffle of order[], a permutation of the population that is
+// kept across tournaments: k swaps per tournament and no rejection retries.
+// The winner is the fittest candidate (the first one on ties).
+typedef int (*TournamentWinnerFn)(const double[], const int[], int);
+
+int tournamentWinnerScalar(const double fitness[], const int candidates[], int k) {
+    int best = candidates[0];
+    for (int j = 1; j < k; j++) {
+        if (fitness[candidates[j]] > fitness[best]) best = candidates[j];
+    }
+    return best;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Gathers four candidate fitness values per instruction and keeps a running
+// vector max; the winner is then the first candidate holding that maximum
+__attribute__((target("avx2")))
+int tournamentWinnerAVX2(const double fitness[], const int candidates[], int k) {
+    if (k < 4) return tournamentWinnerScalar(fitness, candidates, k);
+    
+    __m256d best = _mm256_i32gather_pd(fitness, _mm_loadu_si128((const __m128i *)candidates), 8);
+    int j = 4;
+    for (; j + 4 <= k; j += 4) {
+        __m256d next = _mm256_i32gather_pd(fitness, _mm_loadu_si128((const __m128i *)(candidates + j)), 8);
+        best = _mm256_max_pd(best, next);
+    }
+    __m128d half = _mm_max_pd(_mm256_castpd256_pd128(best), _mm256_extractf128_pd(best, 1));
+    double top = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; j < k; j++) {
+        if (fitness[candidates[j]] > top) top = fitness[candidates[j]];
+    }
+    
+    j = 0;
+    while (fitness[candidates[j]] != top) j++;
+    return candidates[j];
+}
+
+#endif
+
+TournamentWinnerFn selectTournamentKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return tournamentWinnerAVX2;
+#endif
+    return tournamentWinnerScalar;
+}
+
+// parents[] receives indices into pop, so winners are never copied;
+// crossover reads them in place
+void tournamentSelection(const Population *pop, int order[], int parents[], int numSelected, Rng *rng) 
+{
+    // Cached on first use; racing threads store the same pointer
+    static TournamentWinnerFn cached = NULL;
+    TournamentWinnerFn tournamentWinner = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    if (!tournamentWinner) {
+        tournamentWinner = selectTournamentKernel();
+        __atomic_store_n(&cached, tournamentWinner, __ATOMIC_RELAXED);
+    }
+    
+    int n = pop->size;
+    int k = TOURNAMENT_SIZE < n ? TOURNAMENT_SIZE : n;
+    
+    for (int s = 0; s < numSelected; s++) {
+        // Move k random, distinct individuals to the front of order[]
+        for (int j = 0; j < k; j++) {
+            int r = j + rngBounded(rng, n - j);
+            int temp = order[j];
+            order[j] = order[r];
+            order[r] = temp;
+        }
+        
+        parents[s] = tournamentWinner(pop->fitness, order, k);
+    }
+}
+
+// ---- Fitness-proportionate selection ----
+// Roulette and SUS pick individual i with probability fitness[i] / total.
+// Every fitness is 1 / (1 + score) > 0, so no slot of the wheel is empty.
+
+// Walker's alias table: column i keeps i with probability prob[i] and
+// hands over to alias[i] otherwise, so one draw is one column pick plus
+// one coin flip regardless of population size
+typedef struct {
+    double *prob;
+    int *alias;
+    int size;
+} AliasTable;
+
+// Vose's O(n) construction. Columns are scaled so the average holds exactly
+// 1; the under-full ones are topped up from over-full ones. Both worklists
+// share one scratch array: under-full grows up from the front, over-full
+// grows down from the back.
+void buildAliasTable(AliasTable *table, const double weight[], int n, Arena *scratch) {
+    table->prob = arenaAlloc(scratch, n * sizeof *table->prob);
+    table->alias = arenaAlloc(scratch, n * sizeof *table->alias);
+    table->size = n;
+    int *work = arenaAlloc(scratch, n * sizeof *work);
+    
+    double total = 0;
+    for (int i = 0; i < n; i++) total += weight[i];
+    
+    int small = 0, large = n;
+    for (int i = 0; i < n; i++) {
+        table->prob[i] = weight[i] * n / total;
+        table->alias[i] = i;
+        if (table->prob[i] < 1.0) work[small++] = i;
+        else work[--large] = i;
+    }
+    
+    while (small > 0 && large < n) {
+        int under = work[--small];
+        int over = work[large++];
+        table->alias[under] = over;
+        table->prob[over] -= 1.0 - table->prob[under];
+        if (table->prob[over] < 1.0) work[small++] = over;
+        else work[--large] = over;
+    }
+    
+    // Whatever is left is full up to rounding error
+    while (small > 0) table->prob[work[--small]] = 1.0;
+    while (large < n) table->prob[work[large++]] = 1.0;
+}
+
+// Column i keeps i with probability prob[i], otherwise yields alias[i]
+static inline int aliasResolve(const AliasTable *table, int i, Rng *rng) {
+    return rngUnit(rng) < table->prob[i] ? i : table->alias[i];
+}
+
+// Roulette wheel through an alias table rebuilt once per generation from
+// scratch: O(n) to build, O(1) per parent. The columns for all parents come
+// from one bulk fill.
+void rouletteSelection(const Population *pop, int parents[], int numSelected, Arena *scratch, Rng *rng) {
+    AliasTable table;
+    buildAliasTable(&table, pop->fitness, pop->size, scratch);
+    
+    rngFillBounded(rng, parents, numSelected, table.size);
+    for (int s = 0; s < numSelected; s++) {
+        parents[s] = aliasResolve(&table, parents[s], rng);
+    }
 }
 
-// Counts number of threatened pieces (not number of threats)
-int countThreatenedPieces(char chrom[], int threatenedPieces[]) {
-    int numThreatened = 0;
+// Stochastic universal sampling: one spin places numSelected equally spaced
+// pointers on the wheel, and a single pass over the cumulative fitness
+// collects them. Parents come out in population order, so they are shuffled
+// before crossover pairs them up.
+void susSelection(const Population *pop, int parents[], int numSelected, Rng *rng) {
+    double total = 0;
+    for (int i = 0; i < pop->size; i++) total += pop->fitness[i];
     
-    // Initialize threatened array
-    for (int i = 0; i < SIZE; i++) {
-        threatenedPieces[i] = 0;
+    double step = total / numSelected;
+    double pointer = rngUnit(rng) * step;
+    double cumulative = pop->fitness[0];
+    int i = 0;
+    for (int s = 0; s < numSelected; s++) {
+        while (cumulative <= pointer && i < pop->size - 1) cumulative += pop->fitness[++i];
+        parents[s] = i;
+        pointer += step;
     }
     
-    // Check threats for each piece
-    for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'E') continue;
-        
-        int r1 = i / COLS;
-        int c1 = i % COLS;
-        char p1 = chrom[i];
-        
-        for (int j = i + 1; j < SIZE; j++) {
-            if (chrom[j] == 'E') continue;
-            
-            int r2 = j / COLS;
-            int c2 = j % COLS;
-            int threatFromItoJ = 0;
-            int threatFromJtoI = 0;
-            
-            // Check if piece i threatens piece j
-            if (p1 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromItoJ = 1;
-            } else if (p1 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromItoJ = 1;
-            }
-            
-            // Check if piece j threatens piece i
-            char p2 = chrom[j];
-            if (p2 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromJtoI = 1;
-            } else if (p2 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromJtoI = 1;
-            }
-            
-            // Mark threatened pieces
-            if (threatFromItoJ && !threatenedPieces[j]) {
-                threatenedPieces[j] = 1;
-                numThreatened++;
-            }
-            if (threatFromJtoI && !threatenedPieces[i]) {
-                threatenedPieces[i] = 1;
-                numThreatened++;
-            }
-        }
+    for (int s = numSelected - 1; s > 0; s--) {
+        int r = rngBounded(rng, s + 1);
+        int temp = parents[s];
+        parents[s] = parents[r];
+        parents[r] = temp;
     }
-    
-    return numThreatened;
 }
 
-double fitness(char chrom[]) {
-    int threatenedPieces[SIZE];
-    int nb_conflicts = countThreatenedPieces(chrom, threatenedPieces);
-    int penalty = calculatePenalty(chrom);
+// Linear ranking: the population is ranked best first and rank r is drawn
+// with probability proportional to n - r. Inverting that distribution gives
+// r = n * (1 - sqrt(u)), so each parent is one draw after the ranking pass.
+// Unlike the roulette, the pressure does not depend on how far apart the
+// fitness values are.
+void rankSelection(const Population *pop, int parents[], int numSelected, Arena *scratch, Rng *rng) {
+    int n = pop->size;
+    int *ranked = arenaAlloc(scratch, n * sizeof *ranked);
+    rankTop(pop->fitness, n, ranked, n, scratch);
     
-    return 1.0 / (1.0 + nb_conflicts + penalty);
+    for (int s = 0; s < numSelected; s++) {
+        int r = (int)(n * (1.0 - sqrt(rngUnit(rng))));
+        parents[s] = ranked[r < n ? r : n - 1];
+    }
 }
 
-void shuffle(char chrom[]) {
-    for (int i = SIZE - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
-        char temp = chrom[i];
-        chrom[i] = chrom[j];
-        chrom[j] = temp;
+// ---- Selection operators ----
+enum SelectionOperator {
+    SEL_TOURNAMENT = 0,
+    SEL_ROULETTE,
+    SEL_SUS,
+    SEL_RANK,
+    SEL_OPERATORS
+};
+
+typedef struct {
+    const char *name;
+    const char *description;
+} SelectionOperatorInfo;
+
+const SelectionOperatorInfo selectionOperators[SEL_OPERATORS] = {
+    {"tournament", "fittest of k random individuals, O(k) per parent"},
+    {"roulette",   "fitness-proportionate via a Walker alias table, O(1) per parent"},
+    {"sus",        "stochastic universal sampling, one spin for all parents"},
+    {"rank",       "linear ranking, O(1) per parent after one counting-sort pass"},
+};
+
+int selectionOperator = SEL_TOURNAMENT;
+
+// order[] is the run-long tournament permutation; the other operators
+// take their temporaries from scratch
+void selectParents(const Population *pop, int order[], int parents[], int numSelected,
+                   Arena *scratch, Rng *rng) {
+    switch (selectionOperator) {
+        case SEL_ROULETTE: rouletteSelection(pop, parents, numSelected, scratch, rng); return;
+        case SEL_SUS: susSelection(pop, parents, numSelected, rng); return;
+        case SEL_RANK: rankSelection(pop, parents, numSelected, scratch, rng); return;
     }
+    tournamentSelection(pop, order, parents, numSelected, rng);
 }
 
-void printArray(char arr[], int size) {
-    printf("[");
-    for (int i = 0; i < size; i++) {
-        printf("%c", arr[i]);
-        if (i != size - 1) printf(", ");
+// ---- Count-preserving crossover ----
+// A chromosome is a multiset permutation: nQ queens, nR rooks, nB bishops,
+// nK knights and empties spread over SIZE cells. Numbering the occurrences
+// of each type left to right turns it into a true permutation of
+// 0..SIZE-1: type t owns the labels labelBase[t] .. labelBase[t+1]-1. Any
+// permutation crossover on the labels gives a child that maps back to
+// exactly the parents' piece counts, so it needs no repair.
+typedef struct {
+    unsigned char label[SIZE];
+} Labels;
+
+int labelBase[PIECE_TYPES + 1];
+unsigned char typeOfLabel[SIZE];
+
+// Label ranges for the current piece counts; both tables are fixed for a run
+void initLabels() {
+    int counts[PIECE_TYPES] = {SIZE - (nQ + nR + nB + nK), nQ, nR, nB, nK};
+    labelBase[0] = 0;
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        labelBase[t + 1] = labelBase[t] + counts[t];
+        for (int l = labelBase[t]; l < labelBase[t + 1]; l++) typeOfLabel[l] = (unsigned char)t;
     }
-    printf("]");
 }
 
-void printPopulation(char population[][SIZE], double fitnessScores[], int count, char* label) {
-    printf("\n=== %s ===\n", label);
-    for (int i = 0; i < count; i++) {
-        printf("Chromosome %d: ", i);
-        printArray(population[i], SIZE);
-        printf(" | Fitness: %.4f", fitnessScores[i]);
-        
-        // Show conflicts and penalty for debugging
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(population[i], threatenedPieces);
-        int penalty = calculatePenalty(population[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+static inline void labelGenome(Genome g, Labels *out) {
+    int next[PIECE_TYPES];
+    for (int t = 0; t < PIECE_TYPES; t++) next[t] = labelBase[t];
+    for (int i = 0; i < SIZE; i++) out->label[i] = (unsigned char)next[getCell(g, i)]++;
+}
+
+static inline Genome unlabelGenome(const Labels *in) {
+    Genome g = 0;
+    for (int i = 0; i < SIZE; i++) g |= (Genome)typeOfLabel[in->label[i]] << (CELL_BITS * i);
+    return g;
+}
+
+// Partially mapped crossover: the child takes p1's segment [a, b) and p2's
+// labels elsewhere; a p2 label already in the segment is replaced by
+// following the segment's p1 -> p2 mapping until it leaves the segment
+void pmx(const Labels *p1, const Labels *p2, int a, int b, Labels *child) {
+    unsigned char pos1[SIZE];
+    unsigned char inSegment[SIZE] = {0};
+    for (int i = 0; i < SIZE; i++) pos1[p1->label[i]] = (unsigned char)i;
+    for (int i = a; i < b; i++) {
+        child->label[i] = p1->label[i];
+        inSegment[p1->label[i]] = 1;
+    }
+    for (int i = 0; i < SIZE; i++) {
+        if (i >= a && i < b) continue;
+        int v = p2->label[i];
+        while (inSegment[v]) v = p2->label[pos1[v]];
+        child->label[i] = (unsigned char)v;
     }
 }
 
-void copyArray(char dest[], char src[]) {
-    for (int i = 0; i < SIZE; i++)
-        dest[i] = src[i];
+// Order crossover: the child takes p1's segment [a, b), then the remaining
+// labels in the order they appear in p2, both starting right after the
+// segment and wrapping around
+void orderCrossover(const Labels *p1, const Labels *p2, int a, int b, Labels *child) {
+    unsigned char inSegment[SIZE] = {0};
+    for (int i = a; i < b; i++) {
+        child->label[i] = p1->label[i];
+        inSegment[p1->label[i]] = 1;
+    }
+    int out = b % SIZE;
+    for (int j = 0; j < SIZE; j++) {
+        int v = p2->label[(b + j) % SIZE];
+        if (inSegment[v]) continue;
+        child->label[out] = (unsigned char)v;
+        out = (out + 1) % SIZE;
+    }
 }
 
-// Tournament selection
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[][SIZE], int numSelected) 
-{
-    for (int s = 0; s < numSelected; s++) {
-        // Select 2 random individuals
-        int a = rand() % POPULATION_SIZE;
-        int b = rand() % POPULATION_SIZE;
-        
-        // Make sure they're different
-        while (b == a) {
-            b = rand() % POPULATION_SIZE;
+// Cycle crossover: positions split into cycles (i -> position of p2[i] in
+// p1); alternate cycles come from p1 and p2, and child2 is the complement.
+// Every cell keeps a label one of the parents had at that position.
+void cycleCrossover(const Labels *p1, const Labels *p2, Labels *child1, Labels *child2) {
+    unsigned char pos1[SIZE];
+    unsigned char visited[SIZE] = {0};
+    for (int i = 0; i < SIZE; i++) pos1[p1->label[i]] = (unsigned char)i;
+    
+    int fromFirst = 1;
+    for (int start = 0; start < SIZE; start++) {
+        if (visited[start]) continue;
+        int i = start;
+        do {
+            visited[i] = 1;
+            child1->label[i] = fromFirst ? p1->label[i] : p2->label[i];
+            child2->label[i] = fromFirst ? p2->label[i] : p1->label[i];
+            i = pos1[p2->label[i]];
+        } while (i != start);
+        fromFirst = !fromFirst;
+    }
+}
+
+// ---- Crossover operators ----
+enum CrossoverOperator {
+    CX_ONE_POINT = 0,
+    CX_TWO_POINT,
+    CX_UNIFORM,
+    CX_BLOCK,
+    CX_PMX,
+    CX_ORDER,
+    CX_CYCLE,
+    CX_OPERATORS
+};
+
+typedef struct {
+    const char *name;
+    const char *description;
+    int keepsCounts;   // Offspring need no applyPieceConstraints pass
+} CrossoverOperatorInfo;
+
+const CrossoverOperatorInfo crossoverOperators[CX_OPERATORS] = {
+    {"one-point", "random cut, tails swapped; counts repaired afterwards", 0},
+    {"two-point", "random segment swapped; counts repaired afterwards", 0},
+    {"uniform",   "each cell from either parent; counts repaired afterwards", 0},
+    {"block",     "random board rectangle swapped; counts repaired afterwards", 0},
+    {"pmx",       "partially mapped crossover on labelled pieces", 1},
+    {"order",     "order crossover (OX) on labelled pieces", 1},
+    {"cycle",     "cycle crossover (CX) on labelled pieces", 1},
+};
+
+int crossoverOperator = CX_ONE_POINT;
+
+// ---- Mask crossover ----
+// The blend operators build a cell mask and take child 1 as
+// (parent1 & mask) | (parent2 & ~mask), child 2 the other way round, so a
+// pair of children costs one RNG draw and a handful of word operations.
+
+// Cells taken from parent1 under the current blend operator
+Genome blendMask(Rng *rng) {
+    switch (crossoverOperator) {
+        case CX_TWO_POINT: {
+            // Segment [a, b) holds at least one cell; both ends from one draw
+            uint64_t bits = rngNext(rng) >> 32;
+            int a = bits % SIZE;
+            int b = (bits / SIZE) % SIZE;
+            if (a > b) {
+                int temp = a;
+                a = b;
+                b = temp;
+            }
+            return cellPrefix(b + 1) & ~cellPrefix(a);
         }
+        case CX_UNIFORM:
+            return scatterNibbles((unsigned short)(rngNext(rng) >> 48));
+        case CX_BLOCK: {
+            // Rows r0..r1 by columns c0..c1 of the 4x4 board, two bits each
+            unsigned int bits = (unsigned int)(rngNext(rng) >> 56);
+            int r0 = bits & 3, r1 = (bits >> 2) & 3;
+            int c0 = (bits >> 4) & 3, c1 = (bits >> 6) & 3;
+            if (r0 > r1) { int temp = r0; r0 = r1; r1 = temp; }
+            if (c0 > c1) { int temp = c0; c0 = c1; c1 = temp; }
+            Genome rows = cellPrefix((r1 + 1) * COLS) & ~cellPrefix(r0 * COLS);
+            Genome cols = (cellPrefix(c1 + 1) & ~cellPrefix(c0)) * 0x0001000100010001ULL;
+            return rows & cols;
+        }
+    }
+    // One-point: cells below the point form the head
+    int crossoverPoint = rngBounded(rng, SIZE - 1) + 1;
+    return cellPrefix(crossoverPoint);
+}
+
+// Both children of one pair under a permutation operator
+void permutationCrossover(Genome parent1, Genome parent2, Genome *child1, Genome *child2, Rng *rng) {
+    Labels p1, p2, c1, c2;
+    labelGenome(parent1, &p1);
+    labelGenome(parent2, &p2);
+    
+    if (crossoverOperator == CX_CYCLE) {
+        cycleCrossover(&p1, &p2, &c1, &c2);
+    } else {
+        // Segment [a, b) holds at least one cell
+        int a = rngBounded(rng, SIZE);
+        int b = rngBounded(rng, SIZE);
+        if (a > b) {
+            int temp = a;
+            a = b;
+            b = temp;
+        }
+        b++;
         
-        // Choose the better one (higher fitness)
-        int winner = (fitnessScores[a] > fitnessScores[b]) ? a : b;
-        
-        copyArray(selected[s], population[winner]);
+        if (crossoverOperator == CX_PMX) {
+            pmx(&p1, &p2, a, b, &c1);
+            pmx(&p2, &p1, a, b, &c2);
+        } else {
+            orderCrossover(&p1, &p2, a, b, &c1);
+            orderCrossover(&p2, &p1, a, b, &c2);
+        }
     }
+    
+    *child1 = unlabelGenome(&c1);
+    *child2 = unlabelGenome(&c2);
 }
 
-// Crossover with probability PC
-void crossover(char selected[][SIZE], char offspring[][SIZE], int numSelected) 
+// Crossover with probability PC, parents read in place from pop. Fills
+// offspring [begin, end); begin is even, and end is odd only at the end of
+// the population. Each pair draws from its own stream, keyed by the index
+// of its first child.
+void crossover(const Population *pop, const int parents[], Genome offspring[], int begin, int end,
+               uint64_t seed, int generation) 
 {
-    int offspringCount = 0;
+    const Genome *genome = pop->genome;
+    
+    int offspringCount = begin;
     
     // Create offspring through crossover
-    for (int i = 0; i < numSelected; i += 2) {
-        if (i + 1 >= numSelected) {
+    for (int i = begin; i < end; i += 2) {
+        if (i + 1 >= end) {
             // If odd number, just copy the last one
-            copyArray(offspring[offspringCount++], selected[i]);
+            offspring[offspringCount++] = genome[parents[i]];
             break;
         }
         
-        double randVal = (double)rand() / RAND_MAX;
+        Genome parent1 = genome[parents[i]];
+        Genome parent2 = genome[parents[i + 1]];
+        Rng rng;
+        rngKeyed(&rng, seed, generation, i, STREAM_CROSSOVER);
+        double randVal = rngUnit(&rng);
         
-        if (randVal < PC) {
-            // Perform crossover
-            int crossoverPoint = rand() % (SIZE - 1) + 1;
+        if (randVal < PC && crossoverOperators[crossoverOperator].keepsCounts) {
+            permutationCrossover(parent1, parent2, &offspring[offspringCount],
+                                 &offspring[offspringCount + 1], &rng);
+            offspringCount += 2;
+        } else if (randVal < PC) {
+            Genome mask = blendMask(&rng);
             
-            // Child 1: first part from parent1, second from parent2
-            for (int j = 0; j < crossoverPoint; j++) {
-                offspring[offspringCount][j] = selected[i][j];
-            }
-            for (int j = crossoverPoint; j < SIZE; j++) {
-                offspring[offspringCount][j] = selected[i + 1][j];
-            }
+            // Child 1: masked cells from parent1, the rest from parent2
+            offspring[offspringCount] = (parent1 & mask) | (parent2 & ~mask);
             
-            // Child 2: first part from parent2, second from parent1
-            for (int j = 0; j < crossoverPoint; j++) {
-                offspring[offspringCount + 1][j] = selected[i + 1][j];
-            }
-            for (int j = crossoverPoint; j < SIZE; j++) {
-                offspring[offspringCount + 1][j] = selected[i][j];
-            }
+            // Child 2: masked cells from parent2, the rest from parent1
+            offspring[offspringCount + 1] = (parent2 & mask) | (parent1 & ~mask);
             
             offspringCount += 2;
         } else {
             // No crossover, just copy parents
-            copyArray(offspring[offspringCount], selected[i]);
-            copyArray(offspring[offspringCount + 1], selected[i + 1]);
+            offspring[offspringCount] = parent1;
+            offspring[offspringCount + 1] = parent2;
             offspringCount += 2;
         }
     }
 }
 
 // Mutation with probability PM
-void mutation(char population[][SIZE], int popSize) {
-    for (int i = 0; i < popSize; i++) {
+// Each swap updates the offspring's threat counters incrementally
+// (states is NULL when fitness comes from the lookup table). The per-cell
+// coin flips of a chromosome come from one bulk fill of its own stream.
+void mutation(Genome population[], ThreatState states[], int begin, int end, uint64_t seed, int generation) {
+    for (int i = begin; i < end; i++) {
+        Rng rng;
+        rngKeyed(&rng, seed, generation, i, STREAM_MUTATION);
+        double flips[SIZE];
+        rngFillUnit(&rng, flips, SIZE);
+        
         for (int j = 0; j < SIZE; j++) {
-            double randVal = (double)rand() / RAND_MAX;
-            
-            if (randVal < PM) {
+            if (flips[j] < PM) {
                 // Swap with random position
-                int swapPos = rand() % SIZE;
-                char temp = population[i][j];
-                population[i][j] = population[i][swapPos];
-                population[i][swapPos] = temp;
+                int swapPos = rngBounded(&rng, SIZE);
+                if (states) {
+                    swapCells(&states[i], &population[i], j, swapPos);
+                } else {
+                    population[i] = swapGenomeCells(population[i], j, swapPos);
+                }
             }
         }
     }
 }
 
-// Apply piece count constraints
-void applyPieceConstraints(char population[][SIZE], int popSize) {
-    char pieces[4] = {'Q', 'R', 'B', 'K'};
-    int targets[4] = {nQ, nR, nB, nK};
+// Index of the k-th set bit of mask (k < popcount(mask))
+static inline int selectBit(unsigned short mask, int k) {
+#if defined(__BMI2__)
+    return __builtin_ctz(_pdep_u32(1u << k, mask));
+#else
+    while (k--) mask &= mask - 1;
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Apply piece count constraints. The piece bitboards serve as per-piece
+// position lists and the empty cells as the free list, so each draw picks
+// a cell directly: no retries, at most SIZE picks per chromosome whatever
+// the board density. Excess pieces are removed first, which guarantees
+// enough free cells for the missing ones (the totals never exceed SIZE).
+void applyPieceConstraints(Genome population[], ThreatState states[], int begin, int end,
+                           uint64_t seed, int generation) {
+    int targets[PIECE_TYPES] = {0, nQ, nR, nB, nK};
     
-    for (int i = 0; i < popSize; i++) {
-        // Count current pieces
-        int counts[4] = {0};
-        for (int j = 0; j < SIZE; j++) {
-            if (population[i][j] == 'Q') counts[0]++;
-            else if (population[i][j] == 'R') counts[1]++;
-            else if (population[i][j] == 'B') counts[2]++;
-            else if (population[i][j] == 'K') counts[3]++;
-        }
-        
-        // Adjust counts to match target
-        for (int p = 0; p < 4; p++) {
-            while (counts[p] < targets[p]) {
-                // Find an empty cell to place piece
-                for (int attempt = 0; attempt < 100; attempt++) {
-                    int pos = rand() % SIZE;
-                    if (population[i][pos] == 'E') {
-                        population[i][pos] = pieces[p];
-                        counts[p]++;
-                        break;
-                    }
-                }
+    for (int i = begin; i < end; i++) {
+        Rng rng;
+        rngKeyed(&rng, seed, generation, i, STREAM_REPAIR);
+        
+        for (int p = QUEEN; p <= KNIGHT; p++) {
+            unsigned short cells = cellsOf(population[i], p);
+            int count = __builtin_popcount(cells);
+            
+            while (count > targets[p]) {
+                int pos = selectBit(cells, rngBounded(&rng, count));
+                cells &= (unsigned short)~(1u << pos);
+                count--;
+                if (states) removePiece(&states[i], &population[i], pos);
+                else population[i] = setCell(population[i], pos, EMPTY);
             }
+        }
+        
+        unsigned short freeCells = (unsigned short)~occupiedCells(population[i]);
+        int freeCount = __builtin_popcount(freeCells);
+        for (int p = QUEEN; p <= KNIGHT; p++) {
+            int missing = targets[p] - __builtin_popcount(cellsOf(population[i], p));
             
-            while (counts[p] > targets[p]) {
-                // Find this piece to remove
-                for (int attempt = 0; attempt < 100; attempt++) {
-                    int pos = rand() % SIZE;
-                    if (population[i][pos] == pieces[p]) {
-                        population[i][pos] = 'E';
-                        counts[p]--;
-                        break;
-                    }
-                }
+            for (; missing > 0 && freeCount > 0; missing--) {
+                int pos = selectBit(freeCells, rngBounded(&rng, freeCount));
+                freeCells &= (unsigned short)~(1u << pos);
+                freeCount--;
+                if (states) placePiece(&states[i], &population[i], pos, p);
+                else population[i] = setCell(population[i], pos, p);
             }
         }
     }
 }
 
-// Elitism: Keep best individuals
-void elitism(char oldPop[][SIZE], double oldFit[], 
-             char newPop[][SIZE], double newFit[],
-             int eliteCount) 
+// Elitism: Keep best individuals (the index array comes from scratch)
+void elitism(const Population *old, Population *next, int eliteCount, Arena *scratch) 
 {
-    // Create array of indices
-    int indices[POPULATION_SIZE];
-    for (int i = 0; i < POPULATION_SIZE; i++) indices[i] = i;
-    
-    // Sort indices by fitness (descending) using bubble sort
-    for (int i = 0; i < POPULATION_SIZE - 1; i++) {
-        for (int j = 0; j < POPULATION_SIZE - i - 1; j++) {
-            if (oldFit[indices[j]] < oldFit[indices[j + 1]]) {
-                int temp = indices[j];
-                indices[j] = indices[j + 1];
-                indices[j + 1] = temp;
-            }
-        }
-    }
+    // Only the elite are ranked
+    int *indices = arenaAlloc(scratch, eliteCount * sizeof *indices);
+    rankTop(old->fitness, old->size, indices, eliteCount, scratch);
     
     // Copy elite individuals to new population
     for (int i = 0; i < eliteCount; i++) {
-        copyArray(newPop[i], oldPop[indices[i]]);
-        newFit[i] = oldFit[indices[i]];
+        copyIndividual(next, i, old, indices[i]);
+    }
+}
+
+// Replacement: the best 20% of the old population, then the best offspring.
+// Both index orders are generation temporaries taken from scratch.
+void replacement(const Population *old, const Population *offspring, Population *next, Arena *scratch) 
+{
+    // Keep 20% elite
+    int eliteCount = old->size * 0.2;
+    if (eliteCount < 1) eliteCount = 1;
+    
+    elitism(old, next, eliteCount, scratch);
+    
+    // Fill rest with best offspring, ranking only as many as are needed
+    int fill = next->size - eliteCount;
+    int *offspringIndices = arenaAlloc(scratch, fill * sizeof *offspringIndices);
+    rankTop(offspring->fitness, offspring->size, offspringIndices, fill, scratch);
+    
+    // Select best offspring to fill the population
+    for (int i = eliteCount; i < next->size; i++) {
+        copyIndividual(next, i, offspring, offspringIndices[i - eliteCount]);
+    }
+}
+
+// ---- Island migration ----
+// With more than one island, each island runs its own evolutionLoop on its
+// own thread with its own population, arena and seed. Every M generations an
+// island sends copies of its best k individuals to the next island of a
+// ring and replaces its worst k with the batch from the previous island.
+// Each link is a single-producer single-consumer ring buffer: the sender
+// alone writes tail, the receiver alone writes head, and neither locks.
+//
+// A receiver takes the batch of the same migration round, waiting for it if
+// the sender is behind, so a seed reproduces an island run whatever the
+// thread timing. Every island sends before it receives, so the slowest
+// island never waits; a link stops waiting once the other end's run is over.
+
+typedef struct {
+    Genome genome;
+    double fitness;
+    Components components;
+} Migrant;
+
+typedef struct {
+    Migrant *slots;
+    unsigned mask;                          // Capacity - 1, capacity a power of two
+    _Alignas(ARENA_ALIGN) unsigned head;    // Next slot to read, written by the receiver
+    _Alignas(ARENA_ALIGN) unsigned tail;    // Next slot to write, written by the sender
+    _Alignas(ARENA_ALIGN) int senderDone;   // Set when the sender's run is over
+    int receiverDone;                       // Set when the receiver's run is over
+} MigrantRing;
+
+typedef struct {
+    int island;
+    int interval;           // Generations between migrations (M)
+    int count;              // Migrants per migration (k)
+    MigrantRing *inbox;     // From the previous island
+    MigrantRing *outbox;    // To the next island
+} Migration;
+
+// Room for a sender up to four rounds ahead; returns 0 when out of memory
+int ringInit(MigrantRing *ring, int count) {
+    unsigned capacity = 1;
+    while (capacity < 4u * count) capacity <<= 1;
+    ring->slots = malloc(capacity * sizeof *ring->slots);
+    ring->mask = capacity - 1;
+    ring->head = ring->tail = 0;
+    ring->senderDone = ring->receiverDone = 0;
+    return ring->slots != NULL;
+}
+
+// Copy individuals best[0..count) into the ring; the batch is dropped when
+// the receiver's run is already over
+void sendMigrants(MigrantRing *ring, const Population *pop, const int best[], int count) {
+    unsigned tail = ring->tail;
+    while (ring->mask + 1 - (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) < (unsigned)count) {
+        if (__atomic_load_n(&ring->receiverDone, __ATOMIC_ACQUIRE)) return;
+        sched_yield();
+    }
+    
+    for (int m = 0; m < count; m++) {
+        Migrant *slot = &ring->slots[(tail + m) & ring->mask];
+        slot->genome = pop->genome[best[m]];
+        slot->fitness = pop->fitness[best[m]];
+        slot->components = pop->components[best[m]];
+    }
+    __atomic_store_n(&ring->tail, tail + count, __ATOMIC_RELEASE);
+}
+
+// Overwrite individuals worst[0..count) with the next batch; returns 0 when
+// the sender's run ended without sending one
+int receiveMigrants(MigrantRing *ring, Population *pop, const int worst[], int count) {
+    unsigned head = ring->head;
+    while (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head < (unsigned)count) {
+        if (__atomic_load_n(&ring->senderDone, __ATOMIC_ACQUIRE)) {
+            // The flag is set after the last send, so look once more
+            if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head >= (unsigned)count) break;
+            return 0;
+        }
+        sched_yield();
+    }
+    
+    for (int m = 0; m < count; m++) {
+        const Migrant *slot = &ring->slots[(head + m) & ring->mask];
+        pop->genome[worst[m]] = slot->genome;
+        pop->fitness[worst[m]] = slot->fitness;
+        pop->components[worst[m]] = slot->components;
+    }
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Send the best k, then replace the worst k (k is at most half the
+// population, so the two never overlap). The ranking comes from scratch.
+void migrate(Population *pop, const Migration *migration, Arena *scratch) {
+    size_t mark = arenaMark(scratch);
+    int n = pop->size;
+    int k = migration->count;
+    
+    int *order = arenaAlloc(scratch, n * sizeof *order);
+    rankTop(pop->fitness, n, order, n, scratch);
+    
+    sendMigrants(migration->outbox, pop, order, k);
+    receiveMigrants(migration->inbox, pop, order + n - k, k);
+    arenaRewind(scratch, mark);
+}
+
+// One generation's offspring work, shared by every chunk
+typedef struct {
+    const Population *pop;
+    const int *parents;
+    Population *offspring;
+    ThreatState *states;        // NULL when offspring are scored from scratch
+    uint64_t seed;
+    int generation;
+} VariationJob;
+
+// Crossover, mutation, repair and fitness for offspring [begin, end). Every
+// draw comes from a stream keyed by the individual, so chunks can run in any
+// order on any thread and give the serial result.
+void variationTask(void *context, int begin, int end) {
+    VariationJob *job = context;
+    Population *offspring = job->offspring;
+    int keepsCounts = crossoverOperators[crossoverOperator].keepsCounts;
+    
+    // The chunk as a population of its own, for the scoring loops
+    Population chunk = {offspring->genome + begin, offspring->fitness + begin,
+                        offspring->components + begin, end - begin};
+    
+    crossover(job->pop, job->parents, offspring->genome, begin, end, job->seed, job->generation);
+    
+    if (!job->states) {
+        // Table lookups are O(1), and blocked attacks are not additive so
+        // the incremental counters do not apply: mutate, repair, then score
+        mutation(offspring->genome, NULL, begin, end, job->seed, job->generation);
+        if (!keepsCounts) {
+            applyPieceConstraints(offspring->genome, NULL, begin, end, job->seed, job->generation);
+        }
+        evaluatePopulation(&chunk);
+        return;
+    }
+    
+    // Build threat counters once; mutation and repair update them in place
+    for (int i = begin; i < end; i++) {
+        initThreatState(&job->states[i], offspring->genome[i]);
+    }
+    
+    // Mutation
+    mutation(offspring->genome, job->states, begin, end, job->seed, job->generation);
+    
+    // Apply piece count constraints; mutation only swaps cells, so this is
+    // needed only after a crossover that breaks the counts
+    if (!keepsCounts) {
+        applyPieceConstraints(offspring->genome, job->states, begin, end, job->seed, job->generation);
     }
+    
+    // Fitness for offspring comes straight from the counters
+    evaluateStates(job->states + begin, &chunk);
+}
+
+// Arena bytes for a run: the initial population, the offspring and next
+// stores, and one generation's temporaries (rewound every generation)
+size_t runArenaBytes(int popSize) {
+    return 3 * populationBytes(popSize) +
+           2 * arenaBytes(popSize * sizeof(int)) +       // tournament order, selected parents
+           arenaBytes(popSize * sizeof(double)) +        // alias table probabilities
+           2 * arenaBytes(popSize * sizeof(int)) +       // alias table columns and worklist
+           arenaBytes(popSize * sizeof(int)) +           // rank selection order
+           rankBytes(popSize) +                          // ranking keys and counters
+           arenaBytes(popSize * sizeof(ThreatState)) +   // offspring counters
+           2 * arenaBytes(popSize * sizeof(int));        // elitism and offspring order
 }
 
-void evolutionLoop(char population[][SIZE], double fitnessScores[], int generations) {
-    printf("\n=== EVOLUTION LOOP START (%d generations) ===\n", generations);
+// Every random draw of generation gen comes from a stream keyed by seed and
+// gen, so a seed reproduces the run exactly whatever the pool's size.
+// Selection and replacement rank the whole population and stay on the
+// calling thread; the offspring work in between is split across the pool.
+// migration is NULL for a single population; islands report one line at a
+// time so that their output does not interleave.
+void evolutionLoop(Population *pop, int generations, Arena *arena, uint64_t seed, ThreadPool *pool,
+                   const Migration *migration) {
+    if (!migration) printf("\n=== EVOLUTION LOOP START (%d generations) ===\n", generations);
+    
+    // Offspring and the next generation live in buffers allocated once; at
+    // the end of a generation the next buffer becomes the population
+    Population offspring, next;
+    if (!allocPopulation(&offspring, pop->size, arena) || !allocPopulation(&next, pop->size, arena)) {
+        printf("Cannot allocate generation buffers for %d individuals.\n", pop->size);
+        return;
+    }
+    
+    // Tournament candidates are drawn from a permutation that lives for the run
+    int *order = arenaAlloc(arena, pop->size * sizeof *order);
+    if (!order) {
+        printf("Cannot allocate generation buffers for %d individuals.\n", pop->size);
+        return;
+    }
+    for (int i = 0; i < pop->size; i++) order[i] = i;
+    
+    // Everything allocated past this mark lives for one generation
+    size_t generationMark = arenaMark(arena);
     
     for (int gen = 1; gen <= generations; gen++) {
-        if (gen % 10 == 0 || gen == 1 || gen == generations) {
+        if (!migration && (gen % 10 == 0 || gen == 1 || gen == generations)) {
             printf("\n================ GENERATION %d ================\n", gen);
         }
         
         // Calculate statistics
-        double bestFit = fitnessScores[0];
+        double bestFit = pop->fitness[0];
         double avgFit = 0;
         int bestIdx = 0;
         
-        for (int i = 0; i < POPULATION_SIZE; i++) {
-            if (fitnessScores[i] > bestFit) {
-                bestFit = fitnessScores[i];
+        for (int i = 0; i < pop->size; i++) {
+            if (pop->fitness[i] > bestFit) {
+                bestFit = pop->fitness[i];
                 bestIdx = i;
             }
-            avgFit += fitnessScores[i];
+            avgFit += pop->fitness[i];
         }
-        avgFit /= POPULATION_SIZE;
+        avgFit /= pop->size;
         
         if (gen % 10 == 0 || gen == 1 || gen == generations) {
-            printf("Best Fitness: %.4f | Average Fitness: %.4f\n", bestFit, avgFit);
+            if (migration) {
+                printf("Island %d | Generation %d | Best Fitness: %.4f | Average Fitness: %.4f\n",
+                       migration->island, gen, bestFit, avgFit);
+            } else {
+                printf("Best Fitness: %.4f | Average Fitness: %.4f\n", bestFit, avgFit);
+            }
         }
         
         // Check for perfect solution
+        if (bestFit == 1.0 && migration) {
+            printf("*** ISLAND %d: PERFECT SOLUTION FOUND IN GENERATION %d ***\n", migration->island, gen);
+            break;
+        }
         if (bestFit == 1.0) {
             printf("\n*** PERFECT SOLUTION FOUND! ***\n");
             printf("Perfect chromosome: ");
-            printArray(population[bestIdx], SIZE);
-            
-            int threatenedPieces[SIZE];
-            int conflicts = countThreatenedPieces(population[bestIdx], threatenedPieces);
-            int penalty = calculatePenalty(population[bestIdx]);
-            printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+            printGenome(pop->genome[bestIdx]);
+            printf(" | Conflicts: %d | Penalty: %d\n",
+                   pop->components[bestIdx].threatened, pop->components[bestIdx].penalty);
             break;
         }
         
-        // Tournament selection
-        char selected[POPULATION_SIZE][SIZE];
-        tournamentSelection(population, fitnessScores, selected, POPULATION_SIZE);
+        // Selection works on the whole population, so it has one stream
+        Rng selectionRng;
+        rngKeyed(&selectionRng, seed, gen, 0, STREAM_SELECTION);
+        int *parents = arenaAlloc(arena, pop->size * sizeof *parents);
+        selectParents(pop, order, parents, pop->size, arena, &selectionRng);
         
-        // Crossover
-        char offspring[POPULATION_SIZE][SIZE];
-        crossover(selected, offspring, POPULATION_SIZE);
+        // Crossover, mutation, repair and fitness; poolRun returns only
+        // when every offspring is scored
+        VariationJob job = {pop, parents, &offspring, NULL, seed, gen};
+        if (!fitnessTable && !blockedAttacks) {
+            job.states = arenaAlloc(arena, offspring.size * sizeof *job.states);
+        }
+        poolRun(pool, variationTask, &job, offspring.size);
         
-        // Mutation
-        mutation(offspring, POPULATION_SIZE);
+        // Create new generation (elitism + offspring)
+        replacement(pop, &offspring, &next, arena);
         
-        // Apply piece count constraints
-        applyPieceConstraints(offspring, POPULATION_SIZE);
+        // Replace old population; one rewind releases every temporary above
+        swapPopulations(pop, &next);
+        arenaRewind(arena, generationMark);
         
-        // Calculate fitness for offspring
-        double offspringFitness[POPULATION_SIZE];
-        for (int i = 0; i < POPULATION_SIZE; i++) {
-            offspringFitness[i] = fitness(offspring[i]);
+        // Exchange with the neighbouring islands, except after the last generation
+        if (migration && gen % migration->interval == 0 && gen < generations) {
+            migrate(pop, migration, arena);
         }
+    }
+    
+    if (!migration) printf("\n=== EVOLUTION LOOP END ===\n");
+}
+
+// Random placements of the piece counts, each individual drawn from its own
+// stream, scored in one batched call
+void randomPopulation(Population *pop, uint64_t seed) {
+    Genome *genome = pop->genome;
+    
+    for (int i = 0; i < pop->size; i++) {
+        // Start with empty board
+        genome[i] = 0;
+        Rng rng;
+        rngKeyed(&rng, seed, 0, i, STREAM_INIT);
         
-        // Create new generation (elitism + offspring)
-        char newPopulation[POPULATION_SIZE][SIZE];
-        double newFitness[POPULATION_SIZE];
-        
-        // Keep 20% elite
-        int eliteCount = POPULATION_SIZE * 0.2;
-        if (eliteCount < 1) eliteCount = 1;
-        
-        elitism(population, fitnessScores, newPopulation, newFitness, eliteCount);
-        
-        // Fill rest with best offspring
-        // First, sort offspring by fitness
-        int offspringIndices[POPULATION_SIZE];
-        for (int i = 0; i < POPULATION_SIZE; i++) offspringIndices[i] = i;
-        
-        for (int i = 0; i < POPULATION_SIZE - 1; i++) {
-            for (int j = 0; j < POPULATION_SIZE - i - 1; j++) {
-                if (offspringFitness[offspringIndices[j]] < offspringFitness[offspringIndices[j + 1]]) {
-                    int temp = offspringIndices[j];
-                    offspringIndices[j] = offspringIndices[j + 1];
-                    offspringIndices[j + 1] = temp;
+        // Place pieces randomly
+        int placed = 0;
+        int targetQ = nQ, targetR = nR, targetB = nB, targetK = nK;
+        
+        while (placed < (nQ + nR + nB + nK)) {
+            int pos = rngBounded(&rng, SIZE);
+            if (getCell(genome[i], pos) == EMPTY) {
+                if (targetQ > 0) {
+                    genome[i] = setCell(genome[i], pos, QUEEN);
+                    targetQ--;
+                    placed++;
+                } else if (targetR > 0) {
+                    genome[i] = setCell(genome[i], pos, ROOK);
+                    targetR--;
+                    placed++;
+                } else if (targetB > 0) {
+                    genome[i] = setCell(genome[i], pos, BISHOP);
+                    targetB--;
+                    placed++;
+                } else if (targetK > 0) {
+                    genome[i] = setCell(genome[i], pos, KNIGHT);
+                    targetK--;
+                    placed++;
                 }
             }
         }
-        
-        // Select best offspring to fill the population
-        for (int i = eliteCount; i < POPULATION_SIZE; i++) {
-            copyArray(newPopulation[i], offspring[offspringIndices[i - eliteCount]]);
-            newFitness[i] = offspringFitness[offspringIndices[i - eliteCount]];
+    }
+    
+    evaluatePopulation(pop);
+}
+
+// ---- Island model ----
+#ifndef _WIN32
+
+typedef struct {
+    Arena arena;
+    Population population;
+    ThreadPool pool;            // A single worker: the island's own thread
+    Migration migration;
+    uint64_t seed;
+    pthread_t thread;
+} Island;
+
+void *islandMain(void *arg) {
+    Island *island = arg;
+    evolutionLoop(&island->population, MAX_GENERATIONS, &island->arena, island->seed,
+                  &island->pool, &island->migration);
+    
+    // Neighbours stop waiting on this island's links
+    __atomic_store_n(&island->migration.outbox->senderDone, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&island->migration.inbox->receiverDone, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Evolve count populations of POPULATION_SIZE, one thread each, and copy the
+// best individual of island i into slot i of champions. Island seeds come
+// from the ISLAND stream of seed. Returns 0 when an island cannot be set up.
+int runIslands(int count, uint64_t seed, Population *champions) {
+    Island *islands = calloc(count, sizeof *islands);
+    MigrantRing *rings = aligned_alloc(ARENA_ALIGN, count * sizeof *rings);
+    int ready = 0;      // Islands whose arena, rings and pool are set up
+    
+    if (islands && rings) {
+        for (; ready < count; ready++) {
+            Island *island = &islands[ready];
+            if (!ringInit(&rings[ready], MIGRANTS)) break;
+            if (!arenaInit(&island->arena, runArenaBytes(POPULATION_SIZE)) ||
+                !allocPopulation(&island->population, POPULATION_SIZE, &island->arena) ||
+                !poolStart(&island->pool, 1)) {
+                free(rings[ready].slots);
+                arenaFree(&island->arena);
+                break;
+            }
+            
+            Rng rng;
+            rngKeyed(&rng, seed, 0, ready, STREAM_ISLAND);
+            island->seed = rng.s[0];
+            island->migration = (Migration){ready, MIGRATION_INTERVAL, MIGRANTS,
+                                            &rings[(ready + count - 1) % count], &rings[ready]};
+            randomPopulation(&island->population, island->seed);
+        }
+    }
+    
+    int ok = ready == count;
+    if (ok) {
+        for (int i = 0; i < count; i++) {
+            if (pthread_create(&islands[i].thread, NULL, islandMain, &islands[i]) != 0) {
+                // Run without it: its neighbours see a finished island
+                islands[i].thread = pthread_self();
+                rings[i].senderDone = 1;
+                rings[(i + count - 1) % count].receiverDone = 1;
+                printf("Cannot start island %d.\n", i);
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            if (!pthread_equal(islands[i].thread, pthread_self())) pthread_join(islands[i].thread, NULL);
         }
         
-        // Replace old population
-        for (int i = 0; i < POPULATION_SIZE; i++) {
-            copyArray(population[i], newPopulation[i]);
-            fitnessScores[i] = newFitness[i];
+        printf("\n=== ISLAND RESULTS ===\n");
+        for (int i = 0; i < count; i++) {
+            const Population *pop = &islands[i].population;
+            int best = 0;
+            for (int j = 1; j < pop->size; j++) {
+                if (pop->fitness[j] > pop->fitness[best]) best = j;
+            }
+            copyIndividual(champions, i, pop, best);
+            printf("Island %d: ", i);
+            printGenome(pop->genome[best]);
+            printf(" | Fitness: %.4f\n", pop->fitness[best]);
         }
     }
     
-    printf("\n=== EVOLUTION LOOP END ===\n");
+    for (int i = 0; i < ready; i++) {
+        poolStop(&islands[i].pool);
+        arenaFree(&islands[i].arena);
+        free(rings[i].slots);
+    }
+    free(islands);
+    free(rings);
+    return ok;
 }
 
+#endif
+
 int main() {
-    srand(time(NULL));
+    initAttackTables();
     
     printf("=== CHESS PIECE PLACEMENT GENETIC ALGORITHM ===\n");
     
@@ -451,6 +2420,69 @@ int main() {
     printf("Enter population size: ");
     scanf("%d", &POPULATION_SIZE);
     
+    // The same seed and parameters reproduce a run draw for draw
+    unsigned long long seed;
+    printf("Enter random seed (0 to seed from the clock): ");
+    scanf("%llu", &seed);
+    if (seed == 0) seed = (unsigned long long)time(NULL);
+    
+    int islands = 1;
+#ifndef _WIN32
+    printf("Enter number of islands (1 for a single population, 0 for one per core): ");
+    scanf("%d", &islands);
+    if (islands <= 0) islands = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (islands < 1) islands = 1;
+#endif
+    
+    int threads = 1;
+    if (islands > 1) {
+        printf("Enter generations between migrations (M): ");
+        scanf("%d", &MIGRATION_INTERVAL);
+        if (MIGRATION_INTERVAL < 1) MIGRATION_INTERVAL = 1;
+        printf("Enter migrants per island (k): ");
+        scanf("%d", &MIGRANTS);
+        if (MIGRANTS < 1) MIGRANTS = 1;
+        if (MIGRANTS > POPULATION_SIZE / 2) MIGRANTS = POPULATION_SIZE / 2;
+    } else {
+        printf("Enter number of threads (0 for one per core): ");
+        scanf("%d", &threads);
+    }
+    
+    printf("\nSelection operators:\n");
+    for (int s = 0; s < SEL_OPERATORS; s++) {
+        printf("  %d: %-10s %s\n", s, selectionOperators[s].name, selectionOperators[s].description);
+    }
+    while (1) {
+        printf("Choose selection operator (0-%d): ", SEL_OPERATORS - 1);
+        scanf("%d", &selectionOperator);
+        if (selectionOperator < 0 || selectionOperator >= SEL_OPERATORS) {
+            printf("Unknown operator.\n");
+            continue;
+        }
+        break;
+    }
+    
+    if (selectionOperator == SEL_TOURNAMENT) {
+        printf("Enter tournament size k (2 or more): ");
+        scanf("%d", &TOURNAMENT_SIZE);
+        if (TOURNAMENT_SIZE < 2) TOURNAMENT_SIZE = 2;
+        if (TOURNAMENT_SIZE > POPULATION_SIZE) TOURNAMENT_SIZE = POPULATION_SIZE;
+    }
+    
+    printf("\nCrossover operators:\n");
+    for (int x = 0; x < CX_OPERATORS; x++) {
+        printf("  %d: %-10s %s\n", x, crossoverOperators[x].name, crossoverOperators[x].description);
+    }
+    while (1) {
+        printf("Choose crossover operator (0-%d): ", CX_OPERATORS - 1);
+        scanf("%d", &crossoverOperator);
+        if (crossoverOperator < 0 || crossoverOperator >= CX_OPERATORS) {
+            printf("Unknown operator.\n");
+            continue;
+        }
+        break;
+    }
+    
     printf("\n=== SET PIECE COUNTS ===\n");
     while (1) {
         printf("Enter number of Queens (0-16): ");
@@ -477,11 +2509,47 @@ int main() {
         printf("\nGA Parameters:\n");
         printf("  Generations: %d\n", MAX_GENERATIONS);
         printf("  Population: %d\n", POPULATION_SIZE);
+        printf("  Seed: %llu\n", seed);
+        if (islands > 1) {
+            printf("  Islands: %d (k=%d every %d generations)\n", islands, MIGRANTS, MIGRATION_INTERVAL);
+        }
+        printf("  Selection: %s", selectionOperators[selectionOperator].name);
+        if (selectionOperator == SEL_TOURNAMENT) printf(" (k=%d)", TOURNAMENT_SIZE);
+        printf("\n");
+        printf("  Crossover: %s\n", crossoverOperators[crossoverOperator].name);
         printf("  Pieces: Q=%d, R=%d, B=%d, K=%d\n", nQ, nR, nB, nK);
         printf("  Total pieces: %d\n", total);
         printf("  Pc=%.1f, Pm=%.1f\n", PC, PM);
         break;
     }
+    initLabels();
+    
+    char blockedChoice;
+    printf("\nUse blocked attacks (pieces stop at the first piece in their path)? (y/n): ");
+    scanf(" %c", &blockedChoice);
+    blockedAttacks = (blockedChoice == 'y' || blockedChoice == 'Y');
+    
+    printf("\nFitness strategies:\n");
+    for (int f = 0; f < FIT_STRATEGIES; f++) {
+        printf("  %d: %-18s %s\n", f, fitnessStrategies[f].name, fitnessStrategies[f].formula);
+    }
+    while (1) {
+        printf("Choose fitness strategy (0-%d): ", FIT_STRATEGIES - 1);
+        scanf("%d", &fitnessStrategy);
+        if (fitnessStrategy < 0 || fitnessStrategy >= FIT_STRATEGIES) {
+            printf("Unknown strategy.\n");
+            continue;
+        }
+        break;
+    }
+    
+    if (blockedAttacks) {
+        initBlockedTables();
+    } else if (fitnessStrategy == FIT_THREATENED_PENALTY) {
+        // Use the precomputed table from fitgen.c when one exists for these
+        // counts; it stores threatened + penalty, so only this strategy fits
+        loadFitnessTable();
+    }
     
     // Initialize board
     char board[ROWS][COLS];
@@ -510,91 +2578,87 @@ int main() {
     }
     
     // Create initial chromosome
-    char chromosome[SIZE];
+    char cells[SIZE];
     int idx = 0;
     for (int r = 0; r < ROWS; r++)
         for (int c = 0; c < COLS; c++)
-            chromosome[idx++] = board[r][c];
+            cells[idx++] = pieceTypeOf(board[r][c]);
+    Genome chromosome = packChromosome(cells);
     
     printf("\nInitial chromosome from board: ");
-    printArray(chromosome, SIZE);
+    printGenome(chromosome);
     printf("\n");
     
-    // Create initial population
-    char population[POPULATION_SIZE][SIZE];
-    double fitnessScores[POPULATION_SIZE];
+    Arena arena;
+    Population population;
     
-    printf("\n=== CREATING INITIAL POPULATION ===\n");
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        // Start with empty board
-        for (int j = 0; j < SIZE; j++) {
-            population[i][j] = 'E';
+#ifndef _WIN32
+    if (islands > 1) {
+        // Every island owns its arena; this one only holds the island champions
+        printf("\n=== RUNNING %d ISLANDS ===\n", islands);
+        if (!arenaInit(&arena, populationBytes(islands)) ||
+            !allocPopulation(&population, islands, &arena) ||
+            !runIslands(islands, seed, &population)) {
+            printf("Cannot set up %d islands of %d.\n", islands, POPULATION_SIZE);
+            return 1;
         }
-        
-        // Place pieces randomly
-        int placed = 0;
-        int targetQ = nQ, targetR = nR, targetB = nB, targetK = nK;
-        
-        while (placed < (nQ + nR + nB + nK)) {
-            int pos = rand() % SIZE;
-            if (population[i][pos] == 'E') {
-                if (targetQ > 0) {
-                    population[i][pos] = 'Q';
-                    targetQ--;
-                    placed++;
-                } else if (targetR > 0) {
-                    population[i][pos] = 'R';
-                    targetR--;
-                    placed++;
-                } else if (targetB > 0) {
-                    population[i][pos] = 'B';
-                    targetB--;
-                    placed++;
-                } else if (targetK > 0) {
-                    population[i][pos] = 'K';
-                    targetK--;
-                    placed++;
-                }
-            }
+    }
+#endif
+    
+    if (islands == 1) {
+        // Create initial population; every buffer of the run comes from one arena
+        if (!arenaInit(&arena, runArenaBytes(POPULATION_SIZE)) ||
+            !allocPopulation(&population, POPULATION_SIZE, &arena)) {
+            printf("Cannot allocate a population of %d.\n", POPULATION_SIZE);
+            return 1;
         }
         
-        fitnessScores[i] = fitness(population[i]);
+        printf("\n=== CREATING INITIAL POPULATION ===\n");
+        randomPopulation(&population, seed);
         
-        printf("Chromosome %d: ", i);
-        printArray(population[i], SIZE);
+        for (int i = 0; i < POPULATION_SIZE; i++) {
+            printf("Chromosome %d: ", i);
+            printGenome(population.genome[i]);
+            printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", 
+                   population.fitness[i], population.components[i].threatened,
+                   population.components[i].penalty);
+        }
         
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(population[i], threatenedPieces);
-        int penalty = calculatePenalty(population[i]);
-        printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", 
-               fitnessScores[i], conflicts, penalty);
+        // Run evolution
+        ThreadPool pool;
+        if (!poolStart(&pool, threads)) {
+            printf("Cannot start the thread pool.\n");
+            return 1;
+        }
+        printf("\nRunning on %d thread%s\n", pool.workers, pool.workers == 1 ? "" : "s");
+        evolutionLoop(&population, MAX_GENERATIONS, &arena, seed, &pool, NULL);
+        poolStop(&pool);
     }
     
-    // Run evolution
-    evolutionLoop(population, fitnessScores, MAX_GENERATIONS);
-    
     // Display final results
     printf("\n\n=== FINAL RESULTS ===\n");
     
     // Find best solution
-    double bestFit = fitnessScores[0];
+    double bestFit = population.fitness[0];
     int bestIdx = 0;
-    for (int i = 1; i < POPULATION_SIZE; i++) {
-        if (fitnessScores[i] > bestFit) {
-            bestFit = fitnessScores[i];
+    for (int i = 1; i < population.size; i++) {
+        if (population.fitness[i] > bestFit) {
+            bestFit = population.fitness[i];
             bestIdx = i;
         }
     }
+    Genome best = population.genome[bestIdx];
     
     printf("\nBest Solution Found:\n");
     printf("Chromosome: ");
-    printArray(population[bestIdx], SIZE);
+    printGenome(best);
     
-    int threatenedPieces[SIZE];
-    int conflicts = countThreatenedPieces(population[bestIdx], threatenedPieces);
-    int penalty = calculatePenalty(population[bestIdx]);
     printf("\nFitness: %.4f | Conflicts: %d | Penalty: %d\n", 
-           bestFit, conflicts, penalty);
+           bestFit, population.components[bestIdx].threatened,
+           population.components[bestIdx].penalty);
+    
+    int threatenedPieces[SIZE];
+    countThreatenedPieces(best, threatenedPieces);
     
     printf("\nBoard representation:\n");
     printf("    0 1 2 3\n");
@@ -602,8 +2666,8 @@ int main() {
     for (int r = 0; r < ROWS; r++) {
         printf("%d | ", r);
         for (int c = 0; c < COLS; c++) {
-            char piece = population[bestIdx][r * COLS + c];
-            printf("%c ", (piece == 'E') ? '.' : piece);
+            int piece = getCell(best, r * COLS + c);
+            printf("%c ", (piece == EMPTY) ? '.' : pieceSymbol[piece]);
         }
         printf("\n");
     }
@@ -616,29 +2680,27 @@ int main() {
         printf("%d | ", r);
         for (int c = 0; c < COLS; c++) {
             int idx = r * COLS + c;
-            char piece = population[bestIdx][idx];
-            if (piece == 'E') {
+            int piece = getCell(best, idx);
+            if (piece == EMPTY) {
                 printf(". ");
             } else if (threatenedPieces[idx]) {
-                printf("%c*", piece);
+                printf("%c*", pieceSymbol[piece]);
             } else {
-                printf("%c ", piece);
+                printf("%c ", pieceSymbol[piece]);
             }
         }
         printf("\n");
     }
     
     // Count piece types
-    int qCount = 0, rCount = 0, bCount = 0, kCount = 0;
+    int pieceCount[PIECE_TYPES] = {0};
     for (int i = 0; i < SIZE; i++) {
-        if (population[bestIdx][i] == 'Q') qCount++;
-        else if (population[bestIdx][i] == 'R') rCount++;
-        else if (population[bestIdx][i] == 'B') bCount++;
-        else if (population[bestIdx][i] == 'K') kCount++;
+        pieceCount[getCell(best, i)]++;
     }
     
     printf("\nPiece counts in best solution: Q=%d, R=%d, B=%d, K=%d\n", 
-           qCount, rCount, bCount, kCount);
+           pieceCount[QUEEN], pieceCount[ROOK], pieceCount[BISHOP], pieceCount[KNIGHT]);
     
+    arenaFree(&arena);
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -64,7 +66,7 @@ void Conflicts(char chrom[], int out[]) {
     }
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int conflicts[SIZE];
     Conflicts(chrom, conflicts);
     int nb_conflicts = 0;
@@ -73,6 +75,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1 + nb_conflicts);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -105,15 +114,11 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Winners are returned as indices in parents[]; crossover reads them in place
+void tournamentSelection(char population[][SIZE], double fitnessScores[], int parents[6]) 
 {
     printf("\n=== TOURNAMENT SELECTION START ===\n");
     
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < SIZE; j++)
-            selected[i][j] = 'E';
-
     double tempFitnessScores[POPULATION];
     for (int k = 0; k < POPULATION; k++) {
         tempFitnessScores[k] = fitnessScores[k];
@@ -145,44 +150,43 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
             printf("  Winner: Candidate %d (Fitness=%.4f)\n", b, tempFitnessScores[b]);
         }
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
+        parents[s] = winner;
         tempFitnessScores[winner] = -1.0;
         
         printf("  Selected chromosome: ");
-        printArray(selected[s], SIZE);
+        printArray(population[winner], SIZE);
         printf("\n");
     }
     
     printf("\n=== TOURNAMENT SELECTION END - Selected chromosomes ===\n");
     for (int i = 0; i < 6; i++) {
         printf("Selected[%d]: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness: %.4f\n", selectedFitness[i]);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness: %.4f\n", fitnessScores[parents[i]]);
     }
 }
 
-void crossover(char selected[6][SIZE], double selectedFitness[],
+void crossover(char population[][SIZE], double fitnessScores[], int parents[6],
                char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
 {
     printf("\n=== CROSSOVER START ===\n");
     printf("Selected parents for crossover:\n");
     for (int i = 0; i < 6; i++) {
         printf("  Parent[%d]: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness: %.4f\n", selectedFitness[i]);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness: %.4f\n", fitnessScores[parents[i]]);
     }
     
-    char tempPopulation[12][SIZE];
-    double tempFitness[12];
-
-    for (int i = 0; i < 12; i++)
-        for (int j = 0; j < SIZE; j++)
-            tempPopulation[i][j] = 'E';
-    
+    // tempPopulation is a view, not a copy: slots 0-5 point at the parents
+    // in place and slots 6-11 at the rows of finalPopulation the children
+    // are built in
+    char *tempPopulation[12];
+    double *tempFitness[12];
     for (int i = 0; i < 6; i++) {
-        copyArray(tempPopulation[i], selected[i]);
-        tempFitness[i] = selectedFitness[i];
+        tempPopulation[i] = population[parents[i]];
+        tempFitness[i] = &fitnessScores[parents[i]];
+        tempPopulation[i + 6] = finalPopulation[i + 4];
+        tempFitness[i + 6] = &finalFitness[i + 4];
     }
     
     int nextChild = 6;
@@ -192,20 +196,20 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
         
         printf("\nCrossover between Parent[%d] and Parent[%d]:\n", p1, p2);
         
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = tempPopulation[p1][i];
+        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = tempPopulation[p2][i];
+        *tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
         printf("  Child[%d]: ", nextChild);
         printArray(tempPopulation[nextChild], SIZE);
-        printf(" | Fitness: %.4f\n", tempFitness[nextChild]);
+        printf(" | Fitness: %.4f\n", *tempFitness[nextChild]);
         nextChild++;
         
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = tempPopulation[p2][i];
+        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = tempPopulation[p1][i];
+        *tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
         printf("  Child[%d]: ", nextChild);
         printArray(tempPopulation[nextChild], SIZE);
-        printf(" | Fitness: %.4f\n", tempFitness[nextChild]);
+        printf(" | Fitness: %.4f\n", *tempFitness[nextChild]);
         nextChild++;
     }
 
@@ -213,20 +217,18 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
     for (int i = 0; i < 12; i++) {
         printf("Temp[%d]: ", i);
         printArray(tempPopulation[i], SIZE);
-        printf(" | Fitness: %.4f\n", tempFitness[i]);
+        printf(" | Fitness: %.4f\n", *tempFitness[i]);
     }
     
     printf("\nSelecting final population (first 4 parents + 6 children):\n");
     for (int i = 0; i < 4; i++) {
         copyArray(finalPopulation[i], tempPopulation[i]);
-        finalFitness[i] = tempFitness[i];
+        finalFitness[i] = *tempFitness[i];
         printf("  Final[%d] (from parent): ", i);
         printArray(finalPopulation[i], SIZE);
         printf(" | Fitness: %.4f\n", finalFitness[i]);
     }
     for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i + 4], tempPopulation[i + 6]);
-        finalFitness[i + 4] = tempFitness[i + 6];
         printf("  Final[%d] (from child): ", i + 4);
         printArray(finalPopulation[i + 4], SIZE);
         printf(" | Fitness: %.4f\n", finalFitness[i + 4]);
@@ -383,20 +385,19 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             currentFitness[i] = fitnessScores[i];
         }
 
-        char selected[6][SIZE];
-        double selectedFitness[6];
+        int parents[6];
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
         char newPopulation[POPULATION][SIZE];
         double newFitness[POPULATION];
         
-        tournamentSelection(population, currentFitness, selected, selectedFitness);
+        tournamentSelection(population, currentFitness, parents);
         
         for (int i = 0; i < POPULATION; i++) {
             fitnessScores[i] = fitness(population[i]);
         }
 
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, fitnessScores, parents, offspring, offspringFitness);
         
         mutation(offspring, offspringFitness, nQ, nR, nB, nK);
         
@@ -434,6 +435,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
         }
     }
     printf("\n=== EVOLUTION LOOP END ===\n");
+    printCacheStats();
 }
 
 int main() {
@@ -513,8 +515,7 @@ int main() {
     printf("\n=== INITIAL POPULATION ===\n");
     printPopulation(population, fitnessScores, POPULATION, "Initial Population");
     
-    char selected[6][SIZE];
-    double selectedFitness[6];
+    int parents[6];
     char finalPopulation[POPULATION][SIZE];
     double finalFitness[POPULATION];
 
@@ -523,10 +524,10 @@ int main() {
     printf("\n\n=== STEP 1: TOURNAMENT SELECTION ===\n");
     double initialFitnessCopy[POPULATION];
     for(int i = 0; i < POPULATION; i++) initialFitnessCopy[i] = fitnessScores[i];
-    tournamentSelection(population, initialFitnessCopy, selected, selectedFitness);
+    tournamentSelection(population, initialFitnessCopy, parents);
     
     printf("\n\n=== STEP 2: CROSSOVER ===\n");
-    crossover(selected, selectedFitness, finalPopulation, finalFitness);
+    crossover(population, fitnessScores, parents, finalPopulation, finalFitness);
     
     printf("\n\n=== STEP 3: MUTATION ===\n");
     mutation(finalPopulation, finalFitness, nQ, nR, nB, nK);
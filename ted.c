@@ -1,11 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "fitcache.h"
 
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
 const int POPULATION = 10;
+const int TOURNAMENT_SIZE = 2;   // Candidates per tournament (k)
 
 void printBoard(char board[ROWS][COLS]) {
     printf("\nBoard (4x4):\n");
@@ -35,103 +40,117 @@ void readPosition(char piece, int number, char board[ROWS][COLS]) {
     }
 }
 
-int calculatePenalty(char chrom[]) {
-    int penalty = 0;
-    int queensInCol[COLS];
-    
-    for (int i = 0; i < COLS; i++) {
-        queensInCol[i] = 0;
+// Attack bitboards: bit j of xxxAttacks[i] is set when that piece on square i
+// threatens square j. Built once at startup by initAttackTables().
+unsigned short queenAttacks[16];
+unsigned short rookAttacks[16];
+unsigned short bishopAttacks[16];
+unsigned short knightAttacks[16];
+unsigned short columnMask[4];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+        
+        queenAttacks[i] = rookAttacks[i] = bishopAttacks[i] = knightAttacks[i] = 0;
+        
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+            
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+            
+            if (r1 == r2 || c1 == c2)
+                rookAttacks[i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                bishopAttacks[i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                knightAttacks[i] |= bit;
+        }
+        queenAttacks[i] = rookAttacks[i] | bishopAttacks[i];
     }
     
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
+int calculatePenalty(char chrom[]) {
+    unsigned short queens = 0;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'Q') {
-            int col = i % COLS;
-            queensInCol[col]++;
-        }
+        if (chrom[i] == 'Q') queens |= (unsigned short)(1 << i);
     }
     
+    // Penalize each column with more than 1 queen
+    int penalty = 0;
     for (int c = 0; c < COLS; c++) {
-        if (queensInCol[c] > 1) {
-            penalty++; 
-        }
+        unsigned short inCol = queens & columnMask[c];
+        penalty += (inCol & (inCol - 1)) != 0;
     }
     
     return penalty;
 }
 
 int countThreatenedPieces(char chrom[], int threatenedPieces[]) {
-    int numThreatened = 0;
+    unsigned short occupied = 0;
+    unsigned short attacked = 0;
     
+    // OR together the attack set of every piece on the board
     for (int i = 0; i < SIZE; i++) {
-        threatenedPieces[i] = 0;
+        switch (chrom[i]) {
+            case 'Q': attacked |= queenAttacks[i]; break;
+            case 'R': attacked |= rookAttacks[i]; break;
+            case 'B': attacked |= bishopAttacks[i]; break;
+            case 'K': attacked |= knightAttacks[i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
     }
     
+    // A piece is threatened when its square is attacked by any other piece
+    unsigned short threatened = attacked & occupied;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'E') continue;
-        
-        int r1 = i / COLS;
-        int c1 = i % COLS;
-        char p1 = chrom[i];
-        
-        for (int j = i + 1; j < SIZE; j++) {
-            if (chrom[j] == 'E') continue;
-            
-            int r2 = j / COLS;
-            int c2 = j % COLS;
-            int threatFromItoJ = 0;
-            int threatFromJtoI = 0;
-            
-            if (p1 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromItoJ = 1;
-            } else if (p1 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromItoJ = 1;
-            }
-            
-            char p2 = chrom[j];
-            if (p2 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromJtoI = 1;
-            } else if (p2 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromJtoI = 1;
-            }
-            
-            if (threatFromItoJ && !threatenedPieces[j]) {
-                threatenedPieces[j] = 1;
-                numThreatened++;
-            }
-            if (threatFromJtoI && !threatenedPieces[i]) {
-                threatenedPieces[i] = 1;
-                numThreatened++;
-            }
-        }
+        threatenedPieces[i] = (threatened >> i) & 1;
     }
     
-    return numThreatened;
+    return __builtin_popcount(threatened);
+}
+
+// Score components of one chromosome, computed once and carried alongside
+// it so that selection, replacement and the printouts never re-score
+typedef struct {
+    int threatened;
+    int penalty;
+    double fitness;
+} Score;
+
+// Threatened + penalty; higher fitness is a lower score
+#define MAX_SCORE (SIZE + COLS)
+
+static inline int scoreKey(Score score) {
+    return score.threatened + score.penalty;
 }
 
-double fitness(char chrom[]) {
-    int threatenedPieces[SIZE];
-    int nb_conflicts = countThreatenedPieces(chrom, threatenedPieces);
-    int penalty = calculatePenalty(chrom);
+// Memoised through the shared fitness cache, which keeps both components
+Score evaluate(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) {
+        int threatenedPieces[SIZE];
+        entry->parts[0] = countThreatenedPieces(chrom, threatenedPieces);
+        entry->parts[1] = calculatePenalty(chrom);
+        entry->fit = 1.0 / (1.0 + entry->parts[0] + entry->parts[1]);
+    }
     
-    return 1.0 / (1.0 + nb_conflicts + penalty);
+    Score score;
+    score.threatened = entry->parts[0];
+    score.penalty = entry->parts[1];
+    score.fitness = entry->fit;
+    return score;
 }
 
 void shuffle(char chrom[]) {
@@ -152,17 +171,14 @@ void printArray(char arr[], int size) {
     printf("]");
 }
 
-void printPopulation(char population[][SIZE], double fitnessScores[], int count, char* label) {
+void printPopulation(char population[][SIZE], Score scores[], int count, char* label) {
     printf("\n=== %s ===\n", label);
     for (int i = 0; i < count; i++) {
         printf("Chromosome %d: ", i);
         printArray(population[i], SIZE);
-        printf(" | Fitness: %.4f", fitnessScores[i]);
+        printf(" | Fitness: %.4f", scores[i].fitness);
         
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(population[i], threatenedPieces);
-        int penalty = calculatePenalty(population[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Conflicts: %d | Penalty: %d\n", scores[i].threatened, scores[i].penalty);
     }
 }
 
@@ -171,115 +187,148 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Scratch one generation takes, alignment padding included
+size_t generationArenaBytes() {
+    size_t individual = SIZE + sizeof(Score) + 2 * ARENA_ALIGN;
+    return POPULATION * sizeof(int) + ARENA_ALIGN +      // selection candidates
+           2 * POPULATION * individual +                 // offspring and next generation
+           2 * POPULATION * individual +                 // replacement pool
+           2 * POPULATION * sizeof(int) + ARENA_ALIGN;   // replacement order
+}
+
+// Winners are returned as indices in parents[]; crossover reads them in place.
+// available[0..left) holds the individuals not selected yet. Each tournament
+// moves TOURNAMENT_SIZE of them to the front with a partial Fisher-Yates
+// shuffle and removes the winner by swapping in the last entry, so no draw
+// is ever rejected.
+void tournamentSelection(char population[][SIZE], Score scores[], int parents[6], Arena *scratch) 
 {
     printf("\n=== TOURNAMENT SELECTION START ===\n");
-    
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < SIZE; j++)
-            selected[i][j] = 'E';
 
-    double tempFitnessScores[POPULATION];
+    int *available = arenaAlloc(scratch, POPULATION * sizeof *available);
+    int left = POPULATION;
     for (int k = 0; k < POPULATION; k++) {
-        tempFitnessScores[k] = fitnessScores[k];
+        available[k] = k;
     }
     
     printf("Initial population for selection:\n");
     for (int k = 0; k < POPULATION; k++) {
         printf("  %d: ", k);
         printArray(population[k], SIZE);
-        printf(" | Fitness = %.4f", tempFitnessScores[k]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(population[k], threatenedPieces);
-        int penalty = calculatePenalty(population[k]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness = %.4f", scores[k].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", scores[k].threatened, scores[k].penalty);
     }
     
     for (int s = 0; s < 6; s++) {
-        int a, b;
-        do {
-            a = rand() % POPULATION;
-        } while (tempFitnessScores[a] == -1.0);
-        do {
-            b = rand() % POPULATION;
-        } while (b == a || tempFitnessScores[b] == -1.0);
-
-        printf("\nTournament %d:", s+1);
-        printf("\n  Candidate %d: ", a);
-        printArray(population[a], SIZE);
-        printf(" | Fitness=%.4f", tempFitnessScores[a]);
-        int threatenedPiecesA[SIZE];
-        int conflictsA = countThreatenedPieces(population[a], threatenedPiecesA);
-        int penaltyA = calculatePenalty(population[a]);
-        printf(" | Conflicts: %d | Penalty: %d", conflictsA, penaltyA);
+        int k = TOURNAMENT_SIZE < left ? TOURNAMENT_SIZE : left;
         
-        printf("\n  Candidate %d: ", b);
-        printArray(population[b], SIZE);
-        printf(" | Fitness=%.4f", tempFitnessScores[b]);
-        int threatenedPiecesB[SIZE];
-        int conflictsB = countThreatenedPieces(population[b], threatenedPiecesB);
-        int penaltyB = calculatePenalty(population[b]);
-        printf(" | Conflicts: %d | Penalty: %d", conflictsB, penaltyB);
-        
-        int winner;
-        if (tempFitnessScores[a] > tempFitnessScores[b]) {
-            winner = a;
-            printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", a, tempFitnessScores[a]);
-        } else {
-            winner = b;
-            printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", b, tempFitnessScores[b]);
+        printf("\nTournament %d:", s+1);
+        int best = 0;
+        for (int j = 0; j < k; j++) {
+            int r = j + rand() % (left - j);
+            int temp = available[j];
+            available[j] = available[r];
+            available[r] = temp;
+            
+            int c = available[j];
+            printf("\n  Candidate %d: ", c);
+            printArray(population[c], SIZE);
+            printf(" | Fitness=%.4f", scores[c].fitness);
+            printf(" | Conflicts: %d | Penalty: %d", scores[c].threatened, scores[c].penalty);
+            
+            if (scores[c].fitness > scores[available[best]].fitness) best = j;
         }
+        
+        int winner = available[best];
+        printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", winner, scores[winner].fitness);
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
-        tempFitnessScores[winner] = -1.0;
+        parents[s] = winner;
+        available[best] = available[--left];
         
         printf("  Selected chromosome: ");
-        printArray(selected[s], SIZE);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[s], threatenedPieces);
-        int penalty = calculatePenalty(selected[s]);
-        printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", selectedFitness[s], conflicts, penalty);
+        printArray(population[winner], SIZE);
+        printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", scores[winner].fitness, scores[winner].threatened, scores[winner].penalty);
     }
     
     printf("\n=== TOURNAMENT SELECTION END - Selected chromosomes ===\n");
     for (int i = 0; i < 6; i++) {
+        Score *selected = &scores[parents[i]];
         printf("Selected[%d]: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness: %.4f", selectedFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[i], threatenedPieces);
-        int penalty = calculatePenalty(selected[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness: %.4f", selected->fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", selected->threatened, selected->penalty);
+    }
+}
+
+// Index of a cell's symbol in "EQRBK"
+int symbolIndex(char cell) {
+    switch (cell) {
+        case 'Q': return 1;
+        case 'R': return 2;
+        case 'B': return 3;
+        case 'K': return 4;
+    }
+    return 0;
+}
+
+// Partially mapped crossover at the midpoint. Numbering each symbol's
+// occurrences left to right turns a chromosome into a permutation of
+// 0..SIZE-1 whose symbol ranges are fixed by the counts both parents share.
+// The child takes parent1's cells [0, 8) and parent2's labels after that,
+// following the segment's mapping wherever parent2's label is already used,
+// so it keeps the parents' piece counts.
+void pmxMidpoint(char parent1[], char parent2[], char child[]) {
+    const char symbols[5] = {'E', 'Q', 'R', 'B', 'K'};
+    int counts[5] = {0};
+    int next1[5], next2[5];
+    char symbolOf[16];
+    unsigned char label2[16], pos1[16], inSegment[16] = {0};
+    
+    for (int i = 0; i < SIZE; i++) counts[symbolIndex(parent1[i])]++;
+    for (int t = 0, base = 0; t < 5; base += counts[t++]) {
+        next1[t] = next2[t] = base;
+        for (int l = base; l < base + counts[t]; l++) symbolOf[l] = symbols[t];
+    }
+    
+    for (int i = 0; i < SIZE; i++) {
+        int label1 = next1[symbolIndex(parent1[i])]++;
+        label2[i] = (unsigned char)next2[symbolIndex(parent2[i])]++;
+        pos1[label1] = (unsigned char)i;
+        if (i < 8) {
+            child[i] = parent1[i];
+            inSegment[label1] = 1;
+        }
+    }
+    
+    for (int i = 8; i < SIZE; i++) {
+        int v = label2[i];
+        while (inSegment[v]) v = label2[pos1[v]];
+        child[i] = symbolOf[v];
     }
 }
 
-void crossover(char selected[6][SIZE], double selectedFitness[],
-               char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
+void crossover(char population[][SIZE], Score scores[], int parents[6],
+               char finalPopulation[POPULATION][SIZE], Score finalScores[]) 
 {
     printf("\n=== CROSSOVER START ===\n");
     printf("Selected parents for crossover:\n");
     for (int i = 0; i < 6; i++) {
         printf("  Parent[%d]: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness: %.4f", selectedFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[i], threatenedPieces);
-        int penalty = calculatePenalty(selected[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness: %.4f", scores[parents[i]].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", scores[parents[i]].threatened, scores[parents[i]].penalty);
     }
     
-    char tempPopulation[12][SIZE];
-    double tempFitness[12];
-
-    for (int i = 0; i < 12; i++)
-        for (int j = 0; j < SIZE; j++)
-            tempPopulation[i][j] = 'E';
-    
+    // tempPopulation is a view, not a copy: slots 0-5 point at the parents
+    // in place and slots 6-11 at the rows of finalPopulation the children
+    // are built in
+    char *tempPopulation[12];
+    Score *tempScores[12];
     for (int i = 0; i < 6; i++) {
-        copyArray(tempPopulation[i], selected[i]);
-        tempFitness[i] = selectedFitness[i];
+        tempPopulation[i] = population[parents[i]];
+        tempScores[i] = &scores[parents[i]];
+        tempPopulation[i + 6] = finalPopulation[i + 4];
+        tempScores[i + 6] = &finalScores[i + 4];
     }
     
     int nextChild = 6;
@@ -289,27 +338,20 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
         
         printf("\nCrossover between Parent[%d] and Parent[%d]:\n", p1, p2);
         
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        pmxMidpoint(tempPopulation[p1], tempPopulation[p2], tempPopulation[nextChild]);
+        *tempScores[nextChild] = evaluate(tempPopulation[nextChild]);
         printf("  Child[%d]: ", nextChild);
         printArray(tempPopulation[nextChild], SIZE);
-        printf(" | Fitness: %.4f", tempFitness[nextChild]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(tempPopulation[nextChild], threatenedPieces);
-        int penalty = calculatePenalty(tempPopulation[nextChild]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", tempScores[nextChild]->fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", tempScores[nextChild]->threatened, tempScores[nextChild]->penalty);
         nextChild++;
         
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        tempFitness[nextChild] = fitness(tempPopulation[nextChild]);
+        pmxMidpoint(tempPopulation[p2], tempPopulation[p1], tempPopulation[nextChild]);
+        *tempScores[nextChild] = evaluate(tempPopulation[nextChild]);
         printf("  Child[%d]: ", nextChild);
         printArray(tempPopulation[nextChild], SIZE);
-        printf(" | Fitness: %.4f", tempFitness[nextChild]);
-        conflicts = countThreatenedPieces(tempPopulation[nextChild], threatenedPieces);
-        penalty = calculatePenalty(tempPopulation[nextChild]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", tempScores[nextChild]->fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", tempScores[nextChild]->threatened, tempScores[nextChild]->penalty);
         nextChild++;
     }
 
@@ -317,39 +359,33 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
     for (int i = 0; i < 12; i++) {
         printf("Temp[%d]: ", i);
         printArray(tempPopulation[i], SIZE);
-        printf(" | Fitness: %.4f", tempFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(tempPopulation[i], threatenedPieces);
-        int penalty = calculatePenalty(tempPopulation[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", tempScores[i]->fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", tempScores[i]->threatened, tempScores[i]->penalty);
     }
     
     printf("\nSelecting final population (first 4 parents + 6 children):\n");
     for (int i = 0; i < 4; i++) {
         copyArray(finalPopulation[i], tempPopulation[i]);
-        finalFitness[i] = tempFitness[i];
+        finalScores[i] = *tempScores[i];
         printf("  Final[%d] (from parent): ", i);
         printArray(finalPopulation[i], SIZE);
-        printf(" | Fitness: %.4f", finalFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(finalPopulation[i], threatenedPieces);
-        int penalty = calculatePenalty(finalPopulation[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", finalScores[i].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", finalScores[i].threatened, finalScores[i].penalty);
     }
     for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i + 4], tempPopulation[i + 6]);
-        finalFitness[i + 4] = tempFitness[i + 6];
         printf("  Final[%d] (from child): ", i + 4);
         printArray(finalPopulation[i + 4], SIZE);
-        printf(" | Fitness: %.4f", finalFitness[i + 4]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(finalPopulation[i + 4], threatenedPieces);
-        int penalty = calculatePenalty(finalPopulation[i + 4]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", finalScores[i + 4].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", finalScores[i + 4].threatened, finalScores[i + 4].penalty);
     }
 }
 
-void mutation(char population[][SIZE], double fitnessScores[],
+// Crossover keeps the piece counts, so this pass only confirms them. Should
+// a chromosome arrive with wrong counts, the cells are bucketed once into a
+// free list and one position list per piece, and every rand() picks a cell
+// straight from a list: excess pieces are removed first, then missing ones
+// placed, with no retries.
+void mutation(char population[][SIZE], Score scores[],
               int nQ, int nR, int nB, int nK)
 {
     printf("\n=== MUTATION START ===\n");
@@ -361,46 +397,40 @@ void mutation(char population[][SIZE], double fitnessScores[],
     for (int c = 0; c < POPULATION; c++) {
         printf("\nChromosome %d before mutation: ", c);
         printArray(population[c], SIZE);
-        printf(" | Fitness before: %.4f", fitnessScores[c]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(population[c], threatenedPieces);
-        int penalty = calculatePenalty(population[c]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness before: %.4f", scores[c].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", scores[c].threatened, scores[c].penalty);
         
-        int countsBefore[4] = {0};
+        int freeCells[16], freeCount = 0;
+        int positions[4][16], counts[4] = {0};
         for (int i = 0; i < SIZE; i++) {
-            if (population[c][i] == 'Q') countsBefore[0]++;
-            else if (population[c][i] == 'R') countsBefore[1]++;
-            else if (population[c][i] == 'B') countsBefore[2]++;
-            else if (population[c][i] == 'K') countsBefore[3]++;
+            int t = symbolIndex(population[c][i]);
+            if (t == 0) freeCells[freeCount++] = i;
+            else positions[t - 1][counts[t - 1]++] = i;
         }
         printf("  Counts before: Q=%d, R=%d, B=%d, K=%d\n", 
-               countsBefore[0], countsBefore[1], countsBefore[2], countsBefore[3]);
+               counts[0], counts[1], counts[2], counts[3]);
         
         for (int p = 0; p < 4; p++) {
-            int count = 0;
-            for (int i = 0; i < SIZE; i++)
-                if (population[c][i] == pieces[p])
-                    count++;
-
-            printf("  Processing %c: current=%d, target=%d\n", pieces[p], count, targets[p]);
+            printf("  Processing %c: current=%d, target=%d\n", pieces[p], counts[p], targets[p]);
             
-            while (count < targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == 'E') {
-                    population[c][pos] = pieces[p];
-                    count++;
-                    printf("    Added %c at position %d\n", pieces[p], pos);
-                }
+            while (counts[p] > targets[p]) {
+                int k = rand() % counts[p];
+                int pos = positions[p][k];
+                positions[p][k] = positions[p][--counts[p]];
+                population[c][pos] = 'E';
+                freeCells[freeCount++] = pos;
+                printf("    Removed %c from position %d\n", pieces[p], pos);
             }
-            
-            while (count > targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == pieces[p]) {
-                    population[c][pos] = 'E';
-                    count--;
-                    printf("    Removed %c from position %d\n", pieces[p], pos);
-                }
+        }
+        
+        for (int p = 0; p < 4; p++) {
+            while (counts[p] < targets[p] && freeCount > 0) {
+                int k = rand() % freeCount;
+                int pos = freeCells[k];
+                freeCells[k] = freeCells[--freeCount];
+                population[c][pos] = pieces[p];
+                counts[p]++;
+                printf("    Added %c at position %d\n", pieces[p], pos);
             }
         }
         
@@ -414,162 +444,140 @@ void mutation(char population[][SIZE], double fitnessScores[],
         printf("  Counts after: Q=%d, R=%d, B=%d, K=%d\n", 
                countsAfter[0], countsAfter[1], countsAfter[2], countsAfter[3]);
 
-        fitnessScores[c] = fitness(population[c]);
+        scores[c] = evaluate(population[c]);
         printf("  Chromosome after mutation: ");
         printArray(population[c], SIZE);
-        printf(" | Fitness after: %.4f", fitnessScores[c]);
-        int threatenedPiecesAfter[SIZE];
-        int conflictsAfter = countThreatenedPieces(population[c], threatenedPiecesAfter);
-        int penaltyAfter = calculatePenalty(population[c]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflictsAfter, penaltyAfter);
+        printf(" | Fitness after: %.4f", scores[c].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", scores[c].threatened, scores[c].penalty);
     }
     printf("\n=== MUTATION END ===\n");
 }
 
-void replacement(char oldPopulation[][SIZE], double oldFitness[],
-                 char newPopulation[][SIZE], double newFitness[],
-                 char resultPopulation[][SIZE], double resultFitness[]) 
+void replacement(char oldPopulation[][SIZE], Score oldScores[],
+                 char newPopulation[][SIZE], Score newScores[],
+                 char resultPopulation[][SIZE], Score resultScores[], Arena *scratch) 
 {
     printf("\n=== REPLACEMENT START ===\n");
     printf("Old population (size=%d):\n", POPULATION);
     for (int i = 0; i < POPULATION; i++) {
         printf("  Old[%d]: ", i);
         printArray(oldPopulation[i], SIZE);
-        printf(" | Fitness=%.4f", oldFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(oldPopulation[i], threatenedPieces);
-        int penalty = calculatePenalty(oldPopulation[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness=%.4f", oldScores[i].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", oldScores[i].threatened, oldScores[i].penalty);
     }
     
     printf("New population (size=%d):\n", POPULATION);
     for (int i = 0; i < POPULATION; i++) {
         printf("  New[%d]: ", i);
         printArray(newPopulation[i], SIZE);
-        printf(" | Fitness=%.4f", newFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(newPopulation[i], threatenedPieces);
-        int penalty = calculatePenalty(newPopulation[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness=%.4f", newScores[i].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", newScores[i].threatened, newScores[i].penalty);
     }
     
-    char combined[20][SIZE];
-    double combinedFitness[20];
+    char (*combined)[SIZE] = arenaAlloc(scratch, 2 * POPULATION * sizeof *combined);
+    Score *combinedScores = arenaAlloc(scratch, 2 * POPULATION * sizeof *combinedScores);
     
     for (int i = 0; i < POPULATION; i++) {
         copyArray(combined[i], oldPopulation[i]);
-        combinedFitness[i] = oldFitness[i];
+        combinedScores[i] = oldScores[i];
         copyArray(combined[i + POPULATION], newPopulation[i]);
-        combinedFitness[i + POPULATION] = newFitness[i];
+        combinedScores[i + POPULATION] = newScores[i];
     }
     
     printf("\nCombined population (size=20) before sorting:\n");
     for (int i = 0; i < 20; i++) {
         printf("  Combined[%d]: ", i);
         printArray(combined[i], SIZE);
-        printf(" | Fitness: %.4f", combinedFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(combined[i], threatenedPieces);
-        int penalty = calculatePenalty(combined[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
-    }
-    
-    for (int i = 0; i < 19; i++) {
-        for (int j = 0; j < 19 - i; j++) {
-            if (combinedFitness[j] < combinedFitness[j + 1]) {
-                double tempFit = combinedFitness[j];
-                combinedFitness[j] = combinedFitness[j + 1];
-                combinedFitness[j + 1] = tempFit;
-                
-                char tempChrom[SIZE];
-                copyArray(tempChrom, combined[j]);
-                copyArray(combined[j], combined[j + 1]);
-                copyArray(combined[j + 1], tempChrom);
-            }
-        }
+        printf(" | Fitness: %.4f", combinedScores[i].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", combinedScores[i].threatened, combinedScores[i].penalty);
+    }
+    
+    // Fitness is 1 / (1 + threatened + penalty), so sorting by descending
+    // fitness is a stable counting sort on the integer score
+    int *order = arenaAlloc(scratch, 2 * POPULATION * sizeof *order);
+    int start[MAX_SCORE + 1];
+    for (int k = 0; k <= MAX_SCORE; k++) start[k] = 0;
+    for (int i = 0; i < 2 * POPULATION; i++) {
+        start[scoreKey(combinedScores[i])]++;
+    }
+    int rank = 0;
+    for (int k = 0; k <= MAX_SCORE; k++) {
+        int count = start[k];
+        start[k] = rank;
+        rank += count;
+    }
+    for (int i = 0; i < 2 * POPULATION; i++) {
+        order[start[scoreKey(combinedScores[i])]++] = i;
     }
     
     printf("\nCombined population after sorting (descending fitness):\n");
     for (int i = 0; i < 20; i++) {
         printf("  Combined[%d]: ", i);
-        printArray(combined[i], SIZE);
-        printf(" | Fitness: %.4f", combinedFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(combined[i], threatenedPieces);
-        int penalty = calculatePenalty(combined[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printArray(combined[order[i]], SIZE);
+        printf(" | Fitness: %.4f", combinedScores[order[i]].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", combinedScores[order[i]].threatened, combinedScores[order[i]].penalty);
     }
     
     for (int i = 0; i < POPULATION; i++) {
-        copyArray(resultPopulation[i], combined[i]);
-        resultFitness[i] = combinedFitness[i];
+        copyArray(resultPopulation[i], combined[order[i]]);
+        resultScores[i] = combinedScores[order[i]];
     }
     
     printf("\nFinal result population (top %d):\n", POPULATION);
     for (int i = 0; i < POPULATION; i++) {
         printf("  Result[%d]: ", i);
         printArray(resultPopulation[i], SIZE);
-        printf(" | Fitness: %.4f", resultFitness[i]);
-        int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(resultPopulation[i], threatenedPieces);
-        int penalty = calculatePenalty(resultPopulation[i]);
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf(" | Fitness: %.4f", resultScores[i].fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", resultScores[i].threatened, resultScores[i].penalty);
     }
     printf("\n=== REPLACEMENT END ===\n");
 }
 
-void evolutionLoop(char population[][SIZE], double fitnessScores[], 
-                   int nQ, int nR, int nB, int nK, int generations) 
+void evolutionLoop(char population[][SIZE], Score scores[], 
+                   int nQ, int nR, int nB, int nK, int generations, Arena *arena) 
 {
     printf("\n=== EVOLUTION LOOP START ===\n");
     
+    // Everything allocated past this mark lives for one generation
+    size_t generationMark = arenaMark(arena);
+    
     for (int gen = 1; gen <= generations; gen++) {
-        printf("\n\n================ GENERATION %d ================\n", gen);
+        arenaRewind(arena, generationMark);
         
-        printPopulation(population, fitnessScores, POPULATION, "Current Population");
+        printf("\n\n================ GENERATION %d ================\n", gen);
         
-        double currentFitness[POPULATION];
-        for (int i = 0; i < POPULATION; i++) {
-            currentFitness[i] = fitnessScores[i];
-        }
-
-        char selected[6][SIZE];
-        double selectedFitness[6];
-        char offspring[POPULATION][SIZE];
-        double offspringFitness[POPULATION];
-        char newPopulation[POPULATION][SIZE];
-        double newFitness[POPULATION];
+        printPopulation(population, scores, POPULATION, "Current Population");
         
-        tournamentSelection(population, currentFitness, selected, selectedFitness);
+        int parents[6];
+        char (*offspring)[SIZE] = arenaAlloc(arena, POPULATION * sizeof *offspring);
+        Score *offspringScores = arenaAlloc(arena, POPULATION * sizeof *offspringScores);
+        char (*newPopulation)[SIZE] = arenaAlloc(arena, POPULATION * sizeof *newPopulation);
+        Score *newScores = arenaAlloc(arena, POPULATION * sizeof *newScores);
         
-        for (int i = 0; i < POPULATION; i++) {
-            fitnessScores[i] = fitness(population[i]);
-        }
+        tournamentSelection(population, scores, parents, arena);
 
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, scores, parents, offspring, offspringScores);
         
-        mutation(offspring, offspringFitness, nQ, nR, nB, nK);
+        mutation(offspring, offspringScores, nQ, nR, nB, nK);
         
-        replacement(population, fitnessScores, offspring, offspringFitness, 
-                    newPopulation, newFitness);
+        replacement(population, scores, offspring, offspringScores, 
+                    newPopulation, newScores, arena);
         
         for (int i = 0; i < POPULATION; i++) {
             copyArray(population[i], newPopulation[i]);
-            fitnessScores[i] = newFitness[i];
+            scores[i] = newScores[i];
         }
         
-        double bestFit = fitnessScores[0];
+        double bestFit = scores[0].fitness;
         double avgFit = 0;
         int totalConflicts = 0;
         int totalPenalty = 0;
         
         for (int i = 0; i < POPULATION; i++) {
-            if (fitnessScores[i] > bestFit) bestFit = fitnessScores[i];
-            avgFit += fitnessScores[i];
-            
-            int threatenedPieces[SIZE];
-            totalConflicts += countThreatenedPieces(population[i], threatenedPieces);
-            totalPenalty += calculatePenalty(population[i]);
+            if (scores[i].fitness > bestFit) bestFit = scores[i].fitness;
+            avgFit += scores[i].fitness;
+            totalConflicts += scores[i].threatened;
+            totalPenalty += scores[i].penalty;
         }
         avgFit /= POPULATION;
         double avgConflicts = (double)totalConflicts / POPULATION;
@@ -585,23 +593,23 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             printf("\n*** PERFECT SOLUTION FOUND! ***\n");
             printf("Perfect chromosome: ");
             for (int i = 0; i < POPULATION; i++) {
-                if (fitnessScores[i] == 1.0) {
+                if (scores[i].fitness == 1.0) {
                     printArray(population[i], SIZE);
-                    int threatenedPieces[SIZE];
-                    int conflicts = countThreatenedPieces(population[i], threatenedPieces);
-                    int penalty = calculatePenalty(population[i]);
-                    printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+                    printf(" | Conflicts: %d | Penalty: %d\n", scores[i].threatened, scores[i].penalty);
                     break;
                 }
             }
             break;
         }
     }
+    arenaRewind(arena, generationMark);
     printf("\n=== EVOLUTION LOOP END ===\n");
+    printCacheStats();
 }
 
 int main() {
     srand(time(NULL));
+    initAttackTables();
     
     printf("=== CHESS PIECE PLACEMENT GENETIC ALGORITHM ===\n");
     
@@ -666,22 +674,26 @@ int main() {
     
     printf("\nInitial chromosome from board: ");
     printArray(chromosome, SIZE);
-    printf("\nFitness: %.4f", fitness(chromosome));
-    int threatenedPieces[SIZE];
-    int conflicts = countThreatenedPieces(chromosome, threatenedPieces);
-    int penalty = calculatePenalty(chromosome);
-    printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+    Score chromosomeScore = evaluate(chromosome);
+    printf("\nFitness: %.4f", chromosomeScore.fitness);
+    printf(" | Conflicts: %d | Penalty: %d\n", chromosomeScore.threatened, chromosomeScore.penalty);
     
     char population[POPULATION_SIZE][SIZE];
-    double fitnessScores[POPULATION_SIZE];
+    Score scores[POPULATION_SIZE];
+    
+    Arena arena;
+    if (!arenaInit(&arena, generationArenaBytes())) {
+        printf("Cannot allocate generation scratch.\n");
+        return 1;
+    }
     
     printf("\n=== INITIAL POPULATION CREATION ===\n");
     for (int i = 0; i < POPULATION_SIZE; i++) {
         printf("\nCreating chromosome %d:\n", i);
         printf("  Original: ");
         printArray(chromosome, SIZE);
-        printf("\n  Fitness: %.4f", fitness(chromosome));
-        printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
+        printf("\n  Fitness: %.4f", chromosomeScore.fitness);
+        printf(" | Conflicts: %d | Penalty: %d\n", chromosomeScore.threatened, chromosomeScore.penalty);
         
         for (int j = 0; j < SIZE; j++)
             population[i][j] = chromosome[j];
@@ -690,57 +702,53 @@ int main() {
         printf("\n  After shuffle: ");
         printArray(population[i], SIZE);
         
-        fitnessScores[i] = fitness(population[i]);
-        conflicts = countThreatenedPieces(population[i], threatenedPieces);
-        penalty = calculatePenalty(population[i]);
+        scores[i] = evaluate(population[i]);
         printf("\n  Fitness: %.4f | Conflicts: %d | Penalty: %d\n", 
-               fitnessScores[i], conflicts, penalty);
+               scores[i].fitness, scores[i].threatened, scores[i].penalty);
     }
     
     printf("\n=== INITIAL POPULATION ===\n");
-    printPopulation(population, fitnessScores, POPULATION_SIZE, "Initial Population");
+    printPopulation(population, scores, POPULATION_SIZE, "Initial Population");
     
     printf("\n\n=== GENETIC ALGORITHM STEPS ===\n");
     
     printf("\n\n=== STEP 1: TOURNAMENT SELECTION ===\n");
-    char selected[6][SIZE];
-    double selectedFitness[6];
-    double initialFitnessCopy[POPULATION_SIZE];
-    for(int i = 0; i < POPULATION_SIZE; i++) initialFitnessCopy[i] = fitnessScores[i];
-    tournamentSelection(population, initialFitnessCopy, selected, selectedFitness);
+    int parents[6];
+    tournamentSelection(population, scores, parents, &arena);
     
     printf("\n\n=== STEP 2: CROSSOVER ===\n");
     char finalPopulation[POPULATION_SIZE][SIZE];
-    double finalFitness[POPULATION_SIZE];
-    crossover(selected, selectedFitness, finalPopulation, finalFitness);
+    Score finalScores[POPULATION_SIZE];
+    crossover(population, scores, parents, finalPopulation, finalScores);
     
     printf("\n\n=== STEP 3: MUTATION ===\n");
-    mutation(finalPopulation, finalFitness, nQ, nR, nB, nK);
+    mutation(finalPopulation, finalScores, nQ, nR, nB, nK);
     
     printf("\n\n=== STEP 4: REPLACEMENT ===\n");
     char bestPopulation[POPULATION_SIZE][SIZE];
-    double bestFitness[POPULATION_SIZE];
-    replacement(population, fitnessScores, finalPopulation, finalFitness, bestPopulation, bestFitness);
+    Score bestScores[POPULATION_SIZE];
+    replacement(population, scores, finalPopulation, finalScores, bestPopulation, bestScores, &arena);
     
     for (int i = 0; i < POPULATION_SIZE; i++) {
         copyArray(population[i], bestPopulation[i]);
-        fitnessScores[i] = bestFitness[i];
+        scores[i] = bestScores[i];
     }
     
     printf("\n\n=== POPULATION AFTER ONE COMPLETE CYCLE ===\n");
-    printPopulation(population, fitnessScores, POPULATION_SIZE, "Population after one cycle");
+    printPopulation(population, scores, POPULATION_SIZE, "Population after one cycle");
 
     printf("\n\n=== STARTING EVOLUTION LOOP FOR %d GENERATIONS ===\n", MAX_GENERATIONS);
-    evolutionLoop(population, fitnessScores, nQ, nR, nB, nK, MAX_GENERATIONS);
+    arenaRewind(&arena, 0);
+    evolutionLoop(population, scores, nQ, nR, nB, nK, MAX_GENERATIONS, &arena);
     
     printf("\n\n=== FINAL RESULTS ===\n");
-    printPopulation(population, fitnessScores, POPULATION_SIZE, "Final Population");
+    printPopulation(population, scores, POPULATION_SIZE, "Final Population");
     
-    double bestFit = fitnessScores[0];
+    double bestFit = scores[0].fitness;
     int bestIdx = 0;
     for (int i = 1; i < POPULATION_SIZE; i++) {
-        if (fitnessScores[i] > bestFit) {
-            bestFit = fitnessScores[i];
+        if (scores[i].fitness > bestFit) {
+            bestFit = scores[i].fitness;
             bestIdx = i;
         }
     }
@@ -749,10 +757,7 @@ int main() {
     printf("Chromosome: ");
     printArray(population[bestIdx], SIZE);
     printf("\nFitness: %.4f", bestFit);
-    int bestThreatenedPieces[SIZE];
-    int bestConflicts = countThreatenedPieces(population[bestIdx], bestThreatenedPieces);
-    int bestPenalty = calculatePenalty(population[bestIdx]);
-    printf(" | Conflicts: %d | Penalty: %d\n", bestConflicts, bestPenalty);
+    printf(" | Conflicts: %d | Penalty: %d\n", scores[bestIdx].threatened, scores[bestIdx].penalty);
     
     printf("\nBoard representation of best solution:\n");
     printf("    0 1 2 3\n");
@@ -777,5 +782,6 @@ int main() {
     printf("\nPiece counts in best solution: Q=%d, R=%d, B=%d, K=%d\n", 
            qCount, rCount, bCount, kCount);
     
+    arenaFree(&arena);
     return 0;
 }
\ No newline at end of file
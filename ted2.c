@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -37,98 +39,88 @@ void readPosition(char piece, int number, char board[ROWS][COLS]) {
     }
 }
 
-int calculatePenalty(char chrom[]) {
-    int penalty = 0;
-    int queensInCol[COLS];
-    
-    for (int i = 0; i < COLS; i++) {
-        queensInCol[i] = 0;
+// Attack bitboards: bit j of xxxAttacks[i] is set when that piece on square i
+// threatens square j. Built once at startup by initAttackTables().
+unsigned short queenAttacks[16];
+unsigned short rookAttacks[16];
+unsigned short bishopAttacks[16];
+unsigned short knightAttacks[16];
+unsigned short columnMask[4];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+        
+        queenAttacks[i] = rookAttacks[i] = bishopAttacks[i] = knightAttacks[i] = 0;
+        
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+            
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+            
+            if (r1 == r2 || c1 == c2)
+                rookAttacks[i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                bishopAttacks[i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                knightAttacks[i] |= bit;
+        }
+        queenAttacks[i] = rookAttacks[i] | bishopAttacks[i];
     }
     
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
+int calculatePenalty(char chrom[]) {
+    unsigned short queens = 0;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'Q') {
-            int col = i % COLS;
-            queensInCol[col]++;
-        }
+        if (chrom[i] == 'Q') queens |= (unsigned short)(1 << i);
     }
     
+    // Penalize each column with more than 1 queen
+    int penalty = 0;
     for (int c = 0; c < COLS; c++) {
-        if (queensInCol[c] > 1) {
-            penalty++; 
-        }
+        unsigned short inCol = queens & columnMask[c];
+        penalty += (inCol & (inCol - 1)) != 0;
     }
     
     return penalty;
 }
 
 int countThreatenedPieces(char chrom[], int threatenedPieces[]) {
-    int numThreatened = 0;
+    unsigned short occupied = 0;
+    unsigned short attacked = 0;
     
+    // OR together the attack set of every piece on the board
     for (int i = 0; i < SIZE; i++) {
-        threatenedPieces[i] = 0;
+        switch (chrom[i]) {
+            case 'Q': attacked |= queenAttacks[i]; break;
+            case 'R': attacked |= rookAttacks[i]; break;
+            case 'B': attacked |= bishopAttacks[i]; break;
+            case 'K': attacked |= knightAttacks[i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
     }
     
+    // A piece is threatened when its square is attacked by any other piece
+    unsigned short threatened = attacked & occupied;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'E') continue;
-        
-        int r1 = i / COLS;
-        int c1 = i % COLS;
-        char p1 = chrom[i];
-        
-        for (int j = i + 1; j < SIZE; j++) {
-            if (chrom[j] == 'E') continue;
-            
-            int r2 = j / COLS;
-            int c2 = j % COLS;
-            int threatFromItoJ = 0;
-            int threatFromJtoI = 0;
-            
-            if (p1 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromItoJ = 1;
-            } else if (p1 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromItoJ = 1;
-            }
-            
-            char p2 = chrom[j];
-            if (p2 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromJtoI = 1;
-            } else if (p2 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromJtoI = 1;
-            }
-            
-            if (threatFromItoJ && !threatenedPieces[j]) {
-                threatenedPieces[j] = 1;
-                numThreatened++;
-            }
-            if (threatFromJtoI && !threatenedPieces[i]) {
-                threatenedPieces[i] = 1;
-                numThreatened++;
-            }
-        }
+        threatenedPieces[i] = (threatened >> i) & 1;
     }
     
-    return numThreatened;
+    return __builtin_popcount(threatened);
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int threatenedPieces[SIZE];
     int nb_conflicts = countThreatenedPieces(chrom, threatenedPieces);
     int penalty = calculatePenalty(chrom);
@@ -136,6 +128,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_conflicts + penalty);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -173,14 +172,10 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Winners are returned as indices in parents[]; crossover reads them in place
+void tournamentSelection(char population[][SIZE], double fitnessScores[], int parents[6]) 
 {
     printf("\n=== TOURNAMENT SELECTION START ===\n");
-    
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < SIZE; j++)
-            selected[i][j] = 'E';
 
     double tempFitnessScores[POPULATION];
     for (int k = 0; k < POPULATION; k++) {
@@ -233,60 +228,63 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
             printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", b, tempFitnessScores[b]);
         }
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
+        parents[s] = winner;
         tempFitnessScores[winner] = -1.0;
         
         printf("  Selected chromosome: ");
-        printArray(selected[s], SIZE);
+        printArray(population[winner], SIZE);
         int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[s], threatenedPieces);
-        int penalty = calculatePenalty(selected[s]);
-        printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", selectedFitness[s], conflicts, penalty);
+        int conflicts = countThreatenedPieces(population[winner], threatenedPieces);
+        int penalty = calculatePenalty(population[winner]);
+        printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", fitnessScores[winner], conflicts, penalty);
     }
     
     printf("\n=== TOURNAMENT SELECTION END - Selected chromosomes ===\n");
     for (int i = 0; i < 6; i++) {
         printf("Selected[%d]: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness: %.4f", selectedFitness[i]);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness: %.4f", fitnessScores[parents[i]]);
         int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[i], threatenedPieces);
-        int penalty = calculatePenalty(selected[i]);
+        int conflicts = countThreatenedPieces(population[parents[i]], threatenedPieces);
+        int penalty = calculatePenalty(population[parents[i]]);
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
 }
 
-void crossover(char selected[][SIZE], double selectedFitness[],
+// Parents are read in place from population[parents[i]]. The mating pool
+// holds 6 winners, so offspring slots past it reuse the pool from the start.
+void crossover(char population[][SIZE], double fitnessScores[], int parents[6],
                char offspring[][SIZE], double offspringFitness[], int popSize) 
 {
-    for (int i = 0; i < popSize; i++) {
-        copyArray(offspring[i], selected[i]);
-        offspringFitness[i] = selectedFitness[i];
-    }
-
     for (int i = 0; i < popSize - 1; i += 2) {
+        int a = parents[i % 6];
+        int b = parents[(i + 1) % 6];
         double r = (double)rand() / RAND_MAX;
         
         if (r < PC) {
-            char child1[SIZE], child2[SIZE];
-            
             for (int k = 0; k < 8; k++) {
-                child1[k] = selected[i][k];
-                child2[k] = selected[i+1][k];
+                offspring[i][k] = population[a][k];
+                offspring[i+1][k] = population[b][k];
             }
             for (int k = 8; k < SIZE; k++) {
-                child1[k] = selected[i+1][k];
-                child2[k] = selected[i][k];
+                offspring[i][k] = population[b][k];
+                offspring[i+1][k] = population[a][k];
             }
             
-            copyArray(offspring[i], child1);
-            offspringFitness[i] = fitness(child1);
-            
-            copyArray(offspring[i+1], child2);
-            offspringFitness[i+1] = fitness(child2);
+            offspringFitness[i] = fitness(offspring[i]);
+            offspringFitness[i+1] = fitness(offspring[i+1]);
+        } else {
+            copyArray(offspring[i], population[a]);
+            offspringFitness[i] = fitnessScores[a];
+            copyArray(offspring[i+1], population[b]);
+            offspringFitness[i+1] = fitnessScores[b];
         }
     }
+    
+    if (popSize % 2) {
+        copyArray(offspring[popSize-1], population[parents[(popSize-1) % 6]]);
+        offspringFitness[popSize-1] = fitnessScores[parents[(popSize-1) % 6]];
+    }
 }
 
 void mutation(char population[][SIZE], double fitnessScores[],
@@ -439,20 +437,19 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             currentFitness[i] = fitnessScores[i];
         }
 
-        char selected[6][SIZE];
-        double selectedFitness[6];
+        int parents[6];
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
         char newPopulation[POPULATION][SIZE];
         double newFitness[POPULATION];
         
-        tournamentSelection(population, currentFitness, selected, selectedFitness);
+        tournamentSelection(population, currentFitness, parents);
         
         for (int i = 0; i < POPULATION; i++) {
             fitnessScores[i] = fitness(population[i]);
         }
 
-        crossover(selected, selectedFitness, offspring, offspringFitness, POPULATION);
+        crossover(population, fitnessScores, parents, offspring, offspringFitness, POPULATION);
         
         mutation(offspring, offspringFitness, nQ, nR, nB, nK, POPULATION);
         
@@ -504,10 +501,12 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
         }
     }
     printf("\n=== EVOLUTION LOOP END ===\n");
+    printCacheStats();
 }
 
 int main() {
     srand(time(NULL));
+    initAttackTables();
     
     printf("=== CHESS PIECE PLACEMENT GENETIC ALGORITHM ===\n");
     
@@ -606,16 +605,15 @@ int main() {
     printf("\n\n=== GENETIC ALGORITHM STEPS ===\n");
     
     printf("\n\n=== STEP 1: TOURNAMENT SELECTION ===\n");
-    char selected[6][SIZE];
-    double selectedFitness[6];
+    int parents[6];
     double initialFitnessCopy[POPULATION_SIZE];
     for(int i = 0; i < POPULATION_SIZE; i++) initialFitnessCopy[i] = fitnessScores[i];
-    tournamentSelection(population, initialFitnessCopy, selected, selectedFitness);
+    tournamentSelection(population, initialFitnessCopy, parents);
     
     printf("\n\n=== STEP 2: CROSSOVER ===\n");
     char finalPopulation[POPULATION_SIZE][SIZE];
     double finalFitness[POPULATION_SIZE];
-    crossover(selected, selectedFitness, finalPopulation, finalFitness, POPULATION_SIZE);
+    crossover(population, fitnessScores, parents, finalPopulation, finalFitness, POPULATION_SIZE);
     
     printf("\n\n=== STEP 3: MUTATION ===\n");
     mutation(finalPopulation, finalFitness, nQ, nR, nB, nK, POPULATION_SIZE);
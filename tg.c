@@ -3,6 +3,8 @@
 #include <time.h>
 #include <math.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -87,7 +89,7 @@ int countThreatenedPieces(char chrom[]) {
     return total_threatened;
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     // 1. Calculate nb_conflicts (Number of threatened pieces)
     int nb_conflicts = countThreatenedPieces(chrom);
 
@@ -109,6 +111,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_conflicts + penalty);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -141,13 +150,11 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Winners are returned as indices into the population; crossover reads
+// them in place instead of working on copies
+void tournamentSelection(double fitnessScores[], int parents[6]) 
 {
     // Simple logic for brevity: Just picking random tournaments
-    double tempFitnessScores[POPULATION];
-    for (int k = 0; k < POPULATION; k++) tempFitnessScores[k] = fitnessScores[k];
-    
     for (int s = 0; s < 6; s++) {
         int a = rand() % POPULATION;
         int b = rand() % POPULATION;
@@ -155,90 +162,92 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
         while(b == a) b = rand() % POPULATION;
 
         int winner;
-        if (tempFitnessScores[a] > tempFitnessScores[b]) winner = a;
+        if (fitnessScores[a] > fitnessScores[b]) winner = a;
         else winner = b;
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
+        parents[s] = winner;
     }
 }
 
 // Modified Crossover with Probability Pc = 0.8
-void crossover(char selected[6][SIZE], double selectedFitness[],
-               char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
+// Final population: the first 4 parents + 6 children, written directly
+// from population[parents[i]] (offspring fitness is computed after mutation)
+void crossover(char population[][SIZE], int parents[6],
+               char finalPopulation[POPULATION][SIZE]) 
 {
-    char tempPopulation[12][SIZE];
-    double tempFitness[12];
-
-    // Keep parents just in case
-    for (int i = 0; i < 6; i++) {
-        copyArray(tempPopulation[i], selected[i]);
-        tempFitness[i] = selectedFitness[i];
+    for (int i = 0; i < 4; i++) {
+        copyArray(finalPopulation[i], population[parents[i]]);
     }
     
-    int nextChild = 6;
+    int nextChild = 4;
     for (int p = 0; p < 3; p++) {
-        int p1 = p * 2;
-        int p2 = p * 2 + 1;
+        char *p1 = population[parents[p * 2]];
+        char *p2 = population[parents[p * 2 + 1]];
         
         // Generate random number [0, 1]
         double r = (double)rand() / RAND_MAX;
 
         if (r <= CROSSOVER_PROB) {
             // Perform Crossover
-            for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p1][i];
-            for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p2][i];
+            for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p1[i];
+            for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p2[i];
             nextChild++;
             
-            for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p2][i];
-            for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p1][i];
+            for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p2[i];
+            for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p1[i];
             nextChild++;
         } else {
             // No Crossover - Copy Parents directly
-            copyArray(tempPopulation[nextChild], selected[p1]);
+            copyArray(finalPopulation[nextChild], p1);
             nextChild++;
-            copyArray(tempPopulation[nextChild], selected[p2]);
+            copyArray(finalPopulation[nextChild], p2);
             nextChild++;
         }
     }
-
-    // Fill final population (take 4 parents + 6 children to fill 10)
-    for (int i = 0; i < 4; i++) {
-        copyArray(finalPopulation[i], tempPopulation[i]);
-    }
-    for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i + 4], tempPopulation[i + 6]);
-    }
 }
 
 // This function ensures the chromosome has the exact number of pieces required.
 // Crossover can destroy counts (e.g., resulting in 5 Queens), so this repairs it.
+// The cells are bucketed once into a free list and one position list per
+// piece; every rand() then picks a cell straight from a list, so the repair
+// never retries and takes at most SIZE picks however full the board is.
+// Excess pieces are removed first, which guarantees free cells for the
+// missing ones.
 void repairCounts(char chrom[], int nQ, int nR, int nB, int nK) {
     char pieces[4] = {'Q', 'R', 'B', 'K'};
     int targets[4] = {nQ, nR, nB, nK};
+    
+    int freeCells[SIZE], freeCount = 0;
+    int positions[4][SIZE], counts[4] = {0};
+    for (int i = 0; i < SIZE; i++) {
+        if (chrom[i] == 'E') {
+            freeCells[freeCount++] = i;
+            continue;
+        }
+        for (int p = 0; p < 4; p++) {
+            if (chrom[i] == pieces[p]) positions[p][counts[p]++] = i;
+        }
+    }
 
+    // Remove if too many
     for (int p = 0; p < 4; p++) {
-        int count = 0;
-        for (int i = 0; i < SIZE; i++) {
-            if (chrom[i] == pieces[p]) count++;
+        while (counts[p] > targets[p]) {
+            int k = rand() % counts[p];
+            int pos = positions[p][k];
+            positions[p][k] = positions[p][--counts[p]];
+            chrom[pos] = 'E';
+            freeCells[freeCount++] = pos;
         }
+    }
 
-        // Add if missing
-        while (count < targets[p]) {
-            int pos = rand() % SIZE;
-            if (chrom[pos] == 'E') {
-                chrom[pos] = pieces[p];
-                count++;
-            }
-        }
-        
-        // Remove if too many
-        while (count > targets[p]) {
-            int pos = rand() % SIZE;
-            if (chrom[pos] == pieces[p]) {
-                chrom[pos] = 'E';
-                count--;
-            }
+    // Add if missing
+    for (int p = 0; p < 4; p++) {
+        while (counts[p] < targets[p] && freeCount > 0) {
+            int k = rand() % freeCount;
+            int pos = freeCells[k];
+            freeCells[k] = freeCells[--freeCount];
+            chrom[pos] = pieces[p];
+            counts[p]++;
         }
     }
 }
@@ -308,21 +317,17 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
     
     for (int gen = 1; gen <= generations; gen++) {
         
-        double currentFitness[POPULATION];
-        for (int i = 0; i < POPULATION; i++) currentFitness[i] = fitnessScores[i];
-
-        char selected[6][SIZE];
-        double selectedFitness[6];
+        int parents[6];
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
         char newPopulation[POPULATION][SIZE];
         double newFitness[POPULATION];
         
         // 1. Selection
-        tournamentSelection(population, currentFitness, selected, selectedFitness);
+        tournamentSelection(fitnessScores, parents);
         
         // 2. Crossover (Probabilistic)
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, parents, offspring);
         
         // 3. Mutation (Repair + Probabilistic Swap)
         randomMutation(offspring, nQ, nR, nB, nK);
@@ -349,6 +354,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
              break;
         }
     }
+    printCacheStats();
 }
 
 int main() {
@@ -3,11 +3,13 @@
 #include <time.h>
 #include <math.h>
 
+#include "arena.h"
+#include "fitcache.h"
+
 // Constraints and Parameters
 #define SIZE 16
 #define ROWS 4
 #define COLS 4
-#define MAX_POP 100 // Maximum population size limit
 
 // GA Parameters from the image
 const double Pc = 0.8; // Crossover Probability
@@ -43,30 +45,58 @@ void readPosition(char piece, int number, char board[ROWS][COLS]) {
     }
 }
 
+// Attack lookup indexed [type][from][to], built once by initAttackTables().
+// Type 0 is an empty cell and never attacks, so no if/else chain on the piece.
+// attackMask holds the same rows as bitboards (bit j set when square j is
+// attacked) for walking only the attacked squares.
+enum PieceType { EMPTY = 0, QUEEN, ROOK, BISHOP, KNIGHT, PIECE_TYPES };
+unsigned char pieceTypeOf[256];
+unsigned char attackTable[PIECE_TYPES][SIZE][SIZE];
+unsigned short attackMask[PIECE_TYPES][SIZE];
+
+void initAttackTables() {
+    pieceTypeOf['Q'] = QUEEN;
+    pieceTypeOf['R'] = ROOK;
+    pieceTypeOf['B'] = BISHOP;
+    pieceTypeOf['K'] = KNIGHT;
+    
+    for (int i = 0; i < SIZE; i++) {
+        for (int j = 0; j < SIZE; j++) {
+            int r1 = i / COLS, c1 = i % COLS;
+            int r2 = j / COLS, c2 = j % COLS;
+            int line = (r1 == r2 || c1 == c2);
+            int diagonal = (abs(r1 - r2) == abs(c1 - c2));
+            int knight = (abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                         (abs(r1 - r2) == 1 && abs(c1 - c2) == 2);
+            
+            attackTable[EMPTY][i][j] = 0;
+            attackTable[QUEEN][i][j] = line || diagonal;
+            attackTable[ROOK][i][j] = line;
+            attackTable[BISHOP][i][j] = diagonal;
+            attackTable[KNIGHT][i][j] = knight;
+        }
+    }
+    
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        for (int i = 0; i < SIZE; i++) {
+            attackMask[t][i] = 0;
+            for (int j = 0; j < SIZE; j++) {
+                if (j != i && attackTable[t][i][j])
+                    attackMask[t][i] |= (unsigned short)(1 << j);
+            }
+        }
+    }
+}
+
 // Check if piece at index i attacks index j
 int isAttacking(int i, char p1, int j) {
-    int r1 = i / COLS;
-    int c1 = i % COLS;
-    int r2 = j / COLS;
-    int c2 = j % COLS;
-
-    if (p1 == 'Q') {
-        if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2)) return 1;
-    } else if (p1 == 'R') {
-        if (r1 == r2 || c1 == c2) return 1;
-    } else if (p1 == 'B') {
-        if (abs(r1 - r2) == abs(c1 - c2)) return 1;
-    } else if (p1 == 'K') {
-        if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-            (abs(r1 - r2) == 1 && abs(c1 - c2) == 2)) return 1;
-    }
-    return 0;
+    return attackTable[pieceTypeOf[(unsigned char)p1]][i][j];
 }
 
 // MODIFIED: Calculates Fitness based on Image (Eq 2) and User Request
 // 1. Counts "Threatened Pieces" instead of just conflict pairs.
 // 2. Adds Penalty for columns with > 1 Queen.
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int is_threatened[SIZE] = {0}; // Track which pieces are under attack
     int penalty = 0;
 
@@ -109,6 +139,100 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_threatened_pieces + penalty);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
+
+// Per-chromosome threat counters. Every individual carries one, built once
+// at the start of the run and passed along with the chromosome through
+// crossover, mutation and replacement, so a swap or a place/remove
+// only updates the attack relations of the touched squares instead of
+// re-scoring the whole chromosome.
+typedef struct {
+    unsigned char attackers[SIZE];   // Number of pieces attacking each square
+    unsigned char queensInCol[COLS];
+    int threatened;                  // Occupied squares with attackers > 0
+    int penalty;                     // Columns holding more than one queen
+} ThreatState;
+
+// Put a piece on an empty square
+void placePiece(ThreatState *st, char chrom[], int pos, char piece) {
+    chrom[pos] = piece;
+    if (st->attackers[pos]) st->threatened++;
+    
+    unsigned short targets = attackMask[pieceTypeOf[(unsigned char)piece]][pos];
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (st->attackers[j]++ == 0 && chrom[j] != 'E') st->threatened++;
+    }
+    
+    if (piece == 'Q' && ++st->queensInCol[pos % COLS] == 2) st->penalty++;
+}
+
+// Clear an occupied square
+void removePiece(ThreatState *st, char chrom[], int pos) {
+    char piece = chrom[pos];
+    
+    unsigned short targets = attackMask[pieceTypeOf[(unsigned char)piece]][pos];
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (--st->attackers[j] == 0 && chrom[j] != 'E') st->threatened--;
+    }
+    
+    if (st->attackers[pos]) st->threatened--;
+    chrom[pos] = 'E';
+    
+    if (piece == 'Q' && st->queensInCol[pos % COLS]-- == 2) st->penalty--;
+}
+
+void initThreatState(ThreatState *st, char chrom[]) {
+    for (int i = 0; i < SIZE; i++) st->attackers[i] = 0;
+    for (int c = 0; c < COLS; c++) st->queensInCol[c] = 0;
+    st->threatened = 0;
+    st->penalty = 0;
+    
+    // Place pieces onto an empty copy so every relation is counted once
+    char board[SIZE];
+    for (int i = 0; i < SIZE; i++) board[i] = 'E';
+    for (int i = 0; i < SIZE; i++) {
+        if (chrom[i] != 'E') placePiece(st, board, i, chrom[i]);
+    }
+}
+
+// Swap two cells, updating only the attack relations of those squares
+void swapCells(ThreatState *st, char chrom[], int a, int b) {
+    char pa = chrom[a];
+    char pb = chrom[b];
+    if (pa == pb) return;
+    
+    if (pa != 'E') removePiece(st, chrom, a);
+    if (pb != 'E') removePiece(st, chrom, b);
+    if (pb != 'E') placePiece(st, chrom, a, pb);
+    if (pa != 'E') placePiece(st, chrom, b, pa);
+}
+
+// Rewrite cells [from, SIZE) of chrom to match target. Every changed cell
+// is cleared before any is filled, so a piece is only placed on an empty
+// square.
+void rewriteCells(ThreatState *st, char chrom[], const char target[], int from) {
+    for (int i = from; i < SIZE; i++) {
+        if (chrom[i] != target[i] && chrom[i] != 'E') removePiece(st, chrom, i);
+    }
+    for (int i = from; i < SIZE; i++) {
+        if (chrom[i] != target[i]) placePiece(st, chrom, i, target[i]);
+    }
+}
+
+double stateFitness(const ThreatState *st) {
+    return 1.0 / (1.0 + st->threatened + st->penalty);
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -141,15 +265,9 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[][SIZE], double selectedFitness[], int popSize) 
+// The mating pool holds indices into the population; winners are not copied
+void tournamentSelection(double fitnessScores[], int parents[], int popSize) 
 {
-    // Initialize temporary fitness array to mark used candidates (optional, but good for tracking)
-    double tempFitnessScores[MAX_POP];
-    for (int k = 0; k < popSize; k++) {
-        tempFitnessScores[k] = fitnessScores[k];
-    }
-    
     // Select popSize/2 pairs (roughly) or just select enough parents for crossover
     // Here we select 'popSize' parents to fill the mating pool
     for (int s = 0; s < popSize; s++) {
@@ -159,172 +277,223 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
         // Simple tournament
         int winner = (fitnessScores[a] > fitnessScores[b]) ? a : b;
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = fitnessScores[winner];
+        parents[s] = winner;
     }
 }
 
-void crossover(char selected[][SIZE], double selectedFitness[],
-               char offspring[][SIZE], double offspringFitness[], int popSize) 
-{
-    // Initialize offspring with parents
-    for (int i = 0; i < popSize; i++) {
-        copyArray(offspring[i], selected[i]);
-        offspringFitness[i] = selectedFitness[i];
+// Partially mapped crossover at the midpoint. A chromosome is a multiset
+// permutation; numbering each piece type's occurrences left to right turns
+// it into a permutation of 0..SIZE-1 whose type ranges are fixed by the
+// piece counts both parents share. The child takes parent1's cells [0, 8)
+// and parent2's labels after that, following the segment's mapping wherever
+// parent2's label is already used, so it keeps the parents' piece counts.
+void pmxMidpoint(char parent1[], char parent2[], char child[]) {
+    const char symbols[PIECE_TYPES] = {'E', 'Q', 'R', 'B', 'K'};
+    int counts[PIECE_TYPES] = {0};
+    int next1[PIECE_TYPES], next2[PIECE_TYPES];
+    char symbolOf[SIZE];
+    unsigned char label2[SIZE], pos1[SIZE], inSegment[SIZE] = {0};
+    
+    for (int i = 0; i < SIZE; i++) counts[pieceTypeOf[(unsigned char)parent1[i]]]++;
+    for (int t = 0, base = 0; t < PIECE_TYPES; base += counts[t++]) {
+        next1[t] = next2[t] = base;
+        for (int l = base; l < base + counts[t]; l++) symbolOf[l] = symbols[t];
+    }
+    
+    for (int i = 0; i < SIZE; i++) {
+        int label1 = next1[pieceTypeOf[(unsigned char)parent1[i]]]++;
+        label2[i] = (unsigned char)next2[pieceTypeOf[(unsigned char)parent2[i]]]++;
+        pos1[label1] = (unsigned char)i;
+        if (i < 8) {
+            child[i] = parent1[i];
+            inSegment[label1] = 1;
+        }
+    }
+    
+    for (int i = 8; i < SIZE; i++) {
+        int v = label2[i];
+        while (inSegment[v]) v = label2[pos1[v]];
+        child[i] = symbolOf[v];
     }
+}
+
+// A crossover child starts from parent1 and its counters, then only the
+// cells of the second half that differ are rewritten
+void crossChild(char parent1[], const ThreatState *state1, char parent2[],
+                char child[], ThreatState *childState) {
+    char target[SIZE];
+    pmxMidpoint(parent1, parent2, target);
+    copyArray(child, parent1);
+    *childState = *state1;
+    rewriteCells(childState, child, target, 8);
+}
 
+// Parents are read in place from population[parents[i]]; each offspring
+// slot and its counters are written exactly once
+void crossover(char population[][SIZE], double fitnessScores[], ThreatState states[],
+               int parents[], char offspring[][SIZE], double offspringFitness[],
+               ThreatState offspringStates[], int popSize) 
+{
     // Perform crossover in pairs
     for (int i = 0; i < popSize - 1; i += 2) {
+        char *parent1 = population[parents[i]];
+        char *parent2 = population[parents[i+1]];
         
         // MODIFIED: Added Crossover Probability check (Pc = 0.8)
         double r = (double)rand() / RAND_MAX;
         
         if (r < Pc) {
-            // Perform Single Point Crossover (Split at 8)
-            char child1[SIZE], child2[SIZE];
-            
-            for (int k = 0; k < 8; k++) {
-                child1[k] = selected[i][k];
-                child2[k] = selected[i+1][k];
-            }
-            for (int k = 8; k < SIZE; k++) {
-                child1[k] = selected[i+1][k];
-                child2[k] = selected[i][k];
-            }
-            
-            copyArray(offspring[i], child1);
-            offspringFitness[i] = fitness(child1);
+            // Split at 8, with PMX so the piece counts stay valid
+            crossChild(parent1, &states[parents[i]], parent2,
+                       offspring[i], &offspringStates[i]);
+            crossChild(parent2, &states[parents[i+1]], parent1,
+                       offspring[i+1], &offspringStates[i+1]);
             
-            copyArray(offspring[i+1], child2);
-            offspringFitness[i+1] = fitness(child2);
+            offspringFitness[i] = stateFitness(&offspringStates[i]);
+            offspringFitness[i+1] = stateFitness(&offspringStates[i+1]);
+        } else {
+            // Parents are kept as is (cloned to offspring)
+            copyArray(offspring[i], parent1);
+            offspringFitness[i] = fitnessScores[parents[i]];
+            offspringStates[i] = states[parents[i]];
+            copyArray(offspring[i+1], parent2);
+            offspringFitness[i+1] = fitnessScores[parents[i+1]];
+            offspringStates[i+1] = states[parents[i+1]];
         }
-        // If r > Pc, parents are kept as is (cloned to offspring)
+    }
+    
+    // Odd population: the last parent has no partner
+    if (popSize % 2) {
+        copyArray(offspring[popSize-1], population[parents[popSize-1]]);
+        offspringFitness[popSize-1] = fitnessScores[parents[popSize-1]];
+        offspringStates[popSize-1] = states[parents[popSize-1]];
     }
 }
 
-void mutation(char population[][SIZE], double fitnessScores[],
-              int nQ, int nR, int nB, int nK, int popSize)
+// Crossover and swaps both keep the piece counts, so no repair is needed
+void mutation(char population[][SIZE], double fitnessScores[], ThreatState states[],
+              int popSize)
 {
-    char pieces[4] = {'Q', 'R', 'B', 'K'};
-    int targets[4] = {nQ, nR, nB, nK};
-    
     for (int c = 0; c < popSize; c++) {
-        
         // MODIFIED: Added Mutation Probability check (Pm = 0.1)
-        // Note: We perform random swaps if Pm is met. 
-        // Then we ALWAYS perform the "repair" logic to ensure piece counts are valid.
-        
         double r = (double)rand() / RAND_MAX;
         
         if (r < Pm) {
-            // Perform a random swap (Mutation)
+            // Perform a random swap (Mutation); the counters follow the two cells
             int p1 = rand() % SIZE;
             int p2 = rand() % SIZE;
-            char temp = population[c][p1];
-            population[c][p1] = population[c][p2];
-            population[c][p2] = temp;
-        }
-
-        // --- REPAIR / CONSTRAINT HANDLING ---
-        // This part ensures the number of pieces remains correct (Q, R, B, K counts)
-        // This is necessary because crossover might destroy the counts.
-        
-        for (int p = 0; p < 4; p++) {
-            int count = 0;
-            for (int i = 0; i < SIZE; i++)
-                if (population[c][i] == pieces[p]) count++;
-
-            // Add missing pieces
-            while (count < targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == 'E') {
-                    population[c][pos] = pieces[p];
-                    count++;
-                }
-            }
-            
-            // Remove excess pieces
-            while (count > targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == pieces[p]) {
-                    population[c][pos] = 'E';
-                    count--;
-                }
-            }
+            swapCells(&states[c], population[c], p1, p2);
+            fitnessScores[c] = stateFitness(&states[c]);
         }
-        
-        // Update fitness after mutation/repair
-        fitnessScores[c] = fitness(population[c]);
     }
 }
 
-void replacement(char oldPopulation[][SIZE], double oldFitness[],
-                 char newPopulation[][SIZE], double newFitness[],
-                 char resultPopulation[][SIZE], double resultFitness[], int popSize) 
+// Fitness is 1 / (1 + threatened + penalty), so the integer score is an
+// exact sort key: ranking is a counting sort over at most MAX_SCORE + 1
+// keys instead of a comparison sort
+#define MAX_SCORE (SIZE + COLS)
+
+static inline int fitnessKey(double fit) {
+    return (int)(1.0 / fit - 0.5);
+}
+
+// Elitism + Selection: the best popSize of the old and new populations,
+// copied straight into result along with their counters. key[] is
+// caller-owned scratch with room for 2 * popSize entries. Ties keep the
+// combined order (old before new), and individuals that rank below popSize
+// are never copied.
+void replacement(char oldPopulation[][SIZE], double oldFitness[], ThreatState oldStates[],
+                 char newPopulation[][SIZE], double newFitness[], ThreatState newStates[],
+                 char resultPopulation[][SIZE], double resultFitness[],
+                 ThreatState resultStates[], int popSize, int key[]) 
 {
-    // Elitism + Selection: Combine both populations and pick the best
-    struct Individual {
-        char chrom[SIZE];
-        double fit;
-    } all[MAX_POP * 2];
+    int start[MAX_SCORE + 1] = {0};
+    int total = 2 * popSize;
     
-    int total = 0;
     for (int i = 0; i < popSize; i++) {
-        copyArray(all[total].chrom, oldPopulation[i]);
-        all[total].fit = oldFitness[i];
-        total++;
+        key[i] = fitnessKey(oldFitness[i]);
+        key[popSize + i] = fitnessKey(newFitness[i]);
+        start[key[i]]++;
+        start[key[popSize + i]]++;
     }
-    for (int i = 0; i < popSize; i++) {
-        copyArray(all[total].chrom, newPopulation[i]);
-        all[total].fit = newFitness[i];
-        total++;
-    }
-    
-    // Sort descending (Bubble sort for simplicity)
-    for (int i = 0; i < total - 1; i++) {
-        for (int j = 0; j < total - i - 1; j++) {
-            if (all[j].fit < all[j + 1].fit) {
-                struct Individual temp = all[j];
-                all[j] = all[j + 1];
-                all[j + 1] = temp;
-            }
-        }
+    
+    // Counts become the first rank of each score
+    int rank = 0;
+    for (int k = 0; k <= MAX_SCORE; k++) {
+        int count = start[k];
+        start[k] = rank;
+        rank += count;
     }
     
-    // Select top 'popSize'
-    for (int i = 0; i < popSize; i++) {
-        copyArray(resultPopulation[i], all[i].chrom);
-        resultFitness[i] = all[i].fit;
+    for (int i = 0; i < total; i++) {
+        int pos = start[key[i]]++;
+        if (pos >= popSize) continue;
+        if (i < popSize) {
+            copyArray(resultPopulation[pos], oldPopulation[i]);
+            resultFitness[pos] = oldFitness[i];
+            resultStates[pos] = oldStates[i];
+        } else {
+            copyArray(resultPopulation[pos], newPopulation[i - popSize]);
+            resultFitness[pos] = newFitness[i - popSize];
+            resultStates[pos] = newStates[i - popSize];
+        }
     }
 }
 
+// Arena bytes for a run: the population and the offspring and next
+// generation buffers with their counters, plus one generation's temporaries
+size_t runArenaBytes(int popSize) {
+    return 3 * (arenaBytes(popSize * SIZE) + arenaBytes(popSize * sizeof(double)) +
+                arenaBytes(popSize * sizeof(ThreatState))) +
+           arenaBytes(popSize * sizeof(int)) +         // parents
+           arenaBytes(2 * popSize * sizeof(int));      // replacement keys
+}
+
+// Offspring and the next generation live for the run; the mating pool and
+// the ranking keys are taken after a mark that is rewound every generation
 void evolutionLoop(char population[][SIZE], double fitnessScores[], 
-                   int nQ, int nR, int nB, int nK, int generations, int popSize) 
+                   int generations, int popSize, Arena *arena) 
 {
     printf("\n=== EVOLUTION START (Max Gen: %d, Pop: %d) ===\n", generations, popSize);
     printf("Probabilities: Pc = %.2f, Pm = %.2f\n", Pc, Pm);
     
-    char selected[MAX_POP][SIZE];
-    double selectedFitness[MAX_POP];
-    char offspring[MAX_POP][SIZE];
-    double offspringFitness[MAX_POP];
-    char newPopulation[MAX_POP][SIZE];
-    double newFitness[MAX_POP];
+    ThreatState *states = arenaAlloc(arena, popSize * sizeof *states);
+    char (*offspring)[SIZE] = arenaAlloc(arena, popSize * sizeof *offspring);
+    double *offspringFitness = arenaAlloc(arena, popSize * sizeof *offspringFitness);
+    ThreatState *offspringStates = arenaAlloc(arena, popSize * sizeof *offspringStates);
+    char (*newPopulation)[SIZE] = arenaAlloc(arena, popSize * sizeof *newPopulation);
+    double *newFitness = arenaAlloc(arena, popSize * sizeof *newFitness);
+    ThreatState *newStates = arenaAlloc(arena, popSize * sizeof *newStates);
+    if (!states || !offspring || !offspringFitness || !offspringStates ||
+        !newPopulation || !newFitness || !newStates) {
+        printf("Cannot allocate buffers for a population of %d.\n", popSize);
+        return;
+    }
+    
+    // The only full scoring of the run; afterwards the counters are updated
+    for (int i = 0; i < popSize; i++) {
+        initThreatState(&states[i], population[i]);
+    }
+    size_t generationMark = arenaMark(arena);
     
     for (int gen = 1; gen <= generations; gen++) {
+        arenaRewind(arena, generationMark);
+        int *parents = arenaAlloc(arena, popSize * sizeof *parents);
+        int *rankKeys = arenaAlloc(arena, 2 * popSize * sizeof *rankKeys);
         
         // 1. Selection
-        tournamentSelection(population, fitnessScores, selected, selectedFitness, popSize);
+        tournamentSelection(fitnessScores, parents, popSize);
         
         // 2. Crossover (With Pc check)
-        crossover(selected, selectedFitness, offspring, offspringFitness, popSize);
+        crossover(population, fitnessScores, states, parents,
+                  offspring, offspringFitness, offspringStates, popSize);
         
-        // 3. Mutation (With Pm check) & Repair
-        mutation(offspring, offspringFitness, nQ, nR, nB, nK, popSize);
+        // 3. Mutation (With Pm check)
+        mutation(offspring, offspringFitness, offspringStates, popSize);
         
         // 4. Replacement (Elitism)
-        replacement(population, fitnessScores, offspring, offspringFitness, 
-                    newPopulation, newFitness, popSize);
+        replacement(population, fitnessScores, states, offspring, offspringFitness, offspringStates,
+                    newPopulation, newFitness, newStates, popSize, rankKeys);
         
         // Update main population
         double bestFit = 0.0;
@@ -333,6 +502,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
         for (int i = 0; i < popSize; i++) {
             copyArray(population[i], newPopulation[i]);
             fitnessScores[i] = newFitness[i];
+            states[i] = newStates[i];
             
             if (fitnessScores[i] > bestFit) bestFit = fitnessScores[i];
             avgFit += fitnessScores[i];
@@ -346,10 +516,14 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             break;
         }
     }
+    
+    arenaRewind(arena, generationMark);
+    printCacheStats();
 }
 
 int main() {
     srand(time(NULL));
+    initAttackTables();
     
     printf("=== CHESS PIECE PLACEMENT GENETIC ALGORITHM ===\n");
     
@@ -383,9 +557,8 @@ int main() {
     printf("Enter Number of Generations: ");
     scanf("%d", &numberofgen);
     
-    printf("Enter Population Size (e.g. 10, max %d): ", MAX_POP);
+    printf("Enter Population Size (e.g. 10): ");
     scanf("%d", &popSize);
-    if(popSize > MAX_POP) popSize = MAX_POP;
     if(popSize < 2) popSize = 2; // Minimum for crossover
 
     // Place initial pieces
@@ -405,9 +578,18 @@ int main() {
         for (c = 0; c < COLS; c++)
             baseChromosome[idx++] = board[r][c];
     
-    // Initialize Population
-    char population[MAX_POP][SIZE];
-    double fitnessScores[MAX_POP];
+    // Initialize Population; every buffer of the run comes from one arena
+    Arena arena;
+    char (*population)[SIZE] = NULL;
+    double *fitnessScores = NULL;
+    if (arenaInit(&arena, runArenaBytes(popSize))) {
+        population = arenaAlloc(&arena, popSize * sizeof *population);
+        fitnessScores = arenaAlloc(&arena, popSize * sizeof *fitnessScores);
+    }
+    if (!population || !fitnessScores) {
+        printf("Cannot allocate a population of %d.\n", popSize);
+        return 1;
+    }
     
     printf("\nInitializing Population...\n");
     for (int i = 0; i < popSize; i++) {
@@ -419,7 +601,7 @@ int main() {
     printPopulation(population, fitnessScores, (popSize > 5 ? 5 : popSize), "Initial Population (Top 5)");
 
     // Run GA
-    evolutionLoop(population, fitnessScores, nQ, nR, nB, nK, numberofgen, popSize);
+    evolutionLoop(population, fitnessScores, numberofgen, popSize, &arena);
     
     // Final Result
     int bestIdx = 0;
@@ -439,5 +621,6 @@ int main() {
         printf("\n");
     }
     
+    arenaFree(&arena);
     return 0;
 }
\ No newline at end of file
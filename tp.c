@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -64,7 +66,7 @@ void Conflicts(char chrom[], int out[]) {
     }
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int conflicts[SIZE];
     Conflicts(chrom, conflicts);
     int nb_conflicts = 0;
@@ -73,6 +75,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1 + nb_conflicts);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -102,12 +111,12 @@ void printPopulation(char population[][SIZE], double fitnessScores[], int n, con
     }
 }
 
-void printSelected(char selected[][SIZE], double fitnessScores[], int n, const char *title) {
+void printSelected(char population[][SIZE], double fitnessScores[], int parents[], int n, const char *title) {
     printf("\n===== %s =====\n", title);
     for (int i = 0; i < n; i++) {
         printf("Selected %d: ", i);
-        printArray(selected[i], SIZE);
-        printf(" | Fitness = %.4f\n", fitnessScores[i]);
+        printArray(population[parents[i]], SIZE);
+        printf(" | Fitness = %.4f\n", fitnessScores[parents[i]]);
     }
 }
 
@@ -118,13 +127,9 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Winners are returned as population indices; crossover reads them in place
+void tournamentSelection(double fitnessScores[], int parents[6]) 
 {
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < SIZE; j++)
-            selected[i][j] = 'E';
-
     double tempFitnessScores[POPULATION];
     for (int k = 0; k < POPULATION; k++) {
         tempFitnessScores[k] = fitnessScores[k];
@@ -136,48 +141,35 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
         do { b = rand() % POPULATION; } while (b == a || tempFitnessScores[b] == -1.0);
 
         int winner = (tempFitnessScores[a] > tempFitnessScores[b]) ? a : b;
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
+        parents[s] = winner;
         tempFitnessScores[winner] = -1.0;
     }
 }
 
-void crossover(char selected[6][SIZE], double selectedFitness[],
+// First 4 parents + 6 children, written straight into finalPopulation with
+// the parents read in place through parents[]
+void crossover(char population[][SIZE], double fitnessScores[], int parents[6],
                char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
 {
-    char tempPopulation[12][SIZE];
-    double tempFitness[12];
-
-    for (int i = 0; i < 12; i++)
-        for (int j = 0; j < SIZE; j++)
-            tempPopulation[i][j] = 'E';
-
-    for (int i = 0; i < 6; i++) {
-        copyArray(tempPopulation[i], selected[i]);
-        tempFitness[i] = selectedFitness[i];
+    for (int i = 0; i < 4; i++) {
+        copyArray(finalPopulation[i], population[parents[i]]);
+        finalFitness[i] = fitnessScores[parents[i]];
     }
 
-    int nextChild = 6;
+    int nextChild = 4;
     for (int p = 0; p < 3; p++) {
-        int p1 = p * 2;
-        int p2 = p * 2 + 1;
-
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        tempFitness[nextChild++] = fitness(tempPopulation[nextChild - 1]);
-
-        for (int i = 0; i < 8; i++) tempPopulation[nextChild][i] = selected[p2][i];
-        for (int i = 8; i < SIZE; i++) tempPopulation[nextChild][i] = selected[p1][i];
-        tempFitness[nextChild++] = fitness(tempPopulation[nextChild - 1]);
-    }
-
-    for (int i = 0; i < 4; i++) {
-        copyArray(finalPopulation[i], tempPopulation[i]);
-        finalFitness[i] = tempFitness[i];
-    }
-    for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i + 4], tempPopulation[i + 6]);
-        finalFitness[i + 4] = tempFitness[i + 6];
+        char *p1 = population[parents[p * 2]];
+        char *p2 = population[parents[p * 2 + 1]];
+
+        for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p1[i];
+        for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p2[i];
+        finalFitness[nextChild] = fitness(finalPopulation[nextChild]);
+        nextChild++;
+
+        for (int i = 0; i < 8; i++) finalPopulation[nextChild][i] = p2[i];
+        for (int i = 8; i < SIZE; i++) finalPopulation[nextChild][i] = p1[i];
+        finalFitness[nextChild] = fitness(finalPopulation[nextChild]);
+        nextChild++;
     }
 }
 
@@ -252,17 +244,16 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
 {
     for (int gen = 1; gen <= generations; gen++) {
 
-        char selected[6][SIZE];
-        double selectedFitness[6];
+        int parents[6];
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
         char newPopulation[POPULATION][SIZE];
         double newFitness[POPULATION];
 
-        tournamentSelection(population, fitnessScores, selected, selectedFitness);
-        printSelected(selected, selectedFitness, 6, "After Tournament Selection");
+        tournamentSelection(fitnessScores, parents);
+        printSelected(population, fitnessScores, parents, 6, "After Tournament Selection");
 
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, fitnessScores, parents, offspring, offspringFitness);
         printPopulation(offspring, offspringFitness, POPULATION, "After Crossover");
 
         mutation(offspring, offspringFitness, nQ, nR, nB, nK);
@@ -290,6 +281,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             break;
         }
     }
+    printCacheStats();
 }
 
 int main() {
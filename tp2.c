@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
@@ -101,7 +103,7 @@ void Conflicts(char chrom[], int out[]) {
     }
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int conflicts[SIZE];
     Conflicts(chrom, conflicts);
     int nb_conflicts = 0;
@@ -112,6 +114,13 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_conflicts);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -135,17 +144,10 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[6][SIZE], double selectedFitness[]) 
+// Winners are returned as population indices in parents[]; nothing is
+// copied until crossover writes the next generation
+void tournamentSelection(double fitnessScores[], int parents[6]) 
 {
-    // Initialize selected arrays
-    for (int i = 0; i < 6; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            selected[i][j] = 'E';
-        }
-        selectedFitness[i] = 0.0;
-    }
-    
     // Perform 6 tournaments
     for (int t = 0; t < 6; t++) {
         // Randomly select 2 different individuals
@@ -163,9 +165,8 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
             winner = b;
         }
         
-        // Copy the winner
-        copyArray(selected[t], population[winner]);
-        selectedFitness[t] = fitnessScores[winner];
+        // Record the winner
+        parents[t] = winner;
     }
 }
 
@@ -221,13 +222,14 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
     }
 }
 */
-void crossover(char selected[6][SIZE], double selectedFitness[],
+// Parents are read in place from population[parents[i]]
+void crossover(char population[][SIZE], double fitnessScores[], int parents[6],
                char finalPopulation[POPULATION][SIZE], double finalFitness[]) 
 {
     // First, let's put all selected individuals into the population
     for (int i = 0; i < 6; i++) {
-        copyArray(finalPopulation[i], selected[i]);
-        finalFitness[i] = selectedFitness[i];
+        copyArray(finalPopulation[i], population[parents[i]]);
+        finalFitness[i] = fitnessScores[parents[i]];
     }
     
     // Now create 4 children from crossover to fill up to POPULATION (10)
@@ -235,15 +237,15 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
     
     // Create children using different parent pairs
     for (int p = 0; p < 2 && childIndex < POPULATION; p++) {
-        int p1 = p * 2;
-        int p2 = p * 2 + 1;
+        char *p1 = population[parents[p * 2]];
+        char *p2 = population[parents[p * 2 + 1]];
         
         // Child 1: first half from p1, second half from p2
         if (childIndex < POPULATION) {
             for (int i = 0; i < 8; i++) 
-                finalPopulation[childIndex][i] = selected[p1][i];
+                finalPopulation[childIndex][i] = p1[i];
             for (int i = 8; i < SIZE; i++) 
-                finalPopulation[childIndex][i] = selected[p2][i];
+                finalPopulation[childIndex][i] = p2[i];
             finalFitness[childIndex] = fitness(finalPopulation[childIndex]);
             childIndex++;
         }
@@ -251,9 +253,9 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
         // Child 2: first half from p2, second half from p1
         if (childIndex < POPULATION) {
             for (int i = 0; i < 8; i++) 
-                finalPopulation[childIndex][i] = selected[p2][i];
+                finalPopulation[childIndex][i] = p2[i];
             for (int i = 8; i < SIZE; i++) 
-                finalPopulation[childIndex][i] = selected[p1][i];
+                finalPopulation[childIndex][i] = p1[i];
             finalFitness[childIndex] = fitness(finalPopulation[childIndex]);
             childIndex++;
         }
@@ -263,7 +265,7 @@ void crossover(char selected[6][SIZE], double selectedFitness[],
     while (childIndex < POPULATION) {
         // Randomly select a parent to copy
         int parent = rand() % 6;
-        copyArray(finalPopulation[childIndex], selected[parent]);
+        copyArray(finalPopulation[childIndex], population[parents[parent]]);
         
         // Apply some random swaps
         for (int swap = 0; swap < 3; swap++) {
@@ -371,14 +373,13 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
 {
     for (int gen = 1; gen <= generations; gen++) {
         // Selection
-        char selected[6][SIZE];
-        double selectedFitness[6];
-        tournamentSelection(population, fitnessScores, selected, selectedFitness);
+        int parents[6];
+        tournamentSelection(fitnessScores, parents);
         
         // Crossover
         char offspring[POPULATION][SIZE];
         double offspringFitness[POPULATION];
-        crossover(selected, selectedFitness, offspring, offspringFitness);
+        crossover(population, fitnessScores, parents, offspring, offspringFitness);
         
         // Mutation
         mutation(offspring, offspringFitness, nQ, nR, nB, nK);
@@ -423,6 +424,7 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
             printf(" (Fitness: %.3f)\n", bestFit);
         }
     }
+    printCacheStats();
 }
 
 int main() {
@@ -2,11 +2,15 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "arena.h"
+#include "fitcache.h"
+
 const int SIZE = 16;
 const int ROWS = 4;
 const int COLS = 4;
 const double PC = 0.8;
 const double PM = 0.1;
+const int TOURNAMENT_SIZE = 2;   // Candidates per tournament (k)
 
 void printBoard(char board[ROWS][COLS]) {
     printf("\nBoard (4x4):\n");
@@ -36,98 +40,88 @@ void readPosition(char piece, int number, char board[ROWS][COLS]) {
     }
 }
 
-int calculatePenalty(char chrom[]) {
-    int penalty = 0;
-    int queensInCol[COLS];
-    
-    for (int i = 0; i < COLS; i++) {
-        queensInCol[i] = 0;
+// Attack bitboards: bit j of xxxAttacks[i] is set when that piece on square i
+// threatens square j. Built once at startup by initAttackTables().
+unsigned short queenAttacks[16];
+unsigned short rookAttacks[16];
+unsigned short bishopAttacks[16];
+unsigned short knightAttacks[16];
+unsigned short columnMask[4];
+
+void initAttackTables() {
+    for (int i = 0; i < SIZE; i++) {
+        int r1 = i / COLS;
+        int c1 = i % COLS;
+        
+        queenAttacks[i] = rookAttacks[i] = bishopAttacks[i] = knightAttacks[i] = 0;
+        
+        for (int j = 0; j < SIZE; j++) {
+            if (j == i) continue;
+            
+            int r2 = j / COLS;
+            int c2 = j % COLS;
+            unsigned short bit = (unsigned short)(1 << j);
+            
+            if (r1 == r2 || c1 == c2)
+                rookAttacks[i] |= bit;
+            if (abs(r1 - r2) == abs(c1 - c2))
+                bishopAttacks[i] |= bit;
+            if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
+                (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
+                knightAttacks[i] |= bit;
+        }
+        queenAttacks[i] = rookAttacks[i] | bishopAttacks[i];
     }
     
+    for (int c = 0; c < COLS; c++) {
+        columnMask[c] = 0;
+        for (int r = 0; r < ROWS; r++)
+            columnMask[c] |= (unsigned short)(1 << (r * COLS + c));
+    }
+}
+
+int calculatePenalty(char chrom[]) {
+    unsigned short queens = 0;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'Q') {
-            int col = i % COLS;
-            queensInCol[col]++;
-        }
+        if (chrom[i] == 'Q') queens |= (unsigned short)(1 << i);
     }
     
+    // Penalize each column with more than 1 queen
+    int penalty = 0;
     for (int c = 0; c < COLS; c++) {
-        if (queensInCol[c] > 1) {
-            penalty++; 
-        }
+        unsigned short inCol = queens & columnMask[c];
+        penalty += (inCol & (inCol - 1)) != 0;
     }
     
     return penalty;
 }
 
 int countThreatenedPieces(char chrom[], int threatenedPieces[]) {
-    int numThreatened = 0;
+    unsigned short occupied = 0;
+    unsigned short attacked = 0;
     
+    // OR together the attack set of every piece on the board
     for (int i = 0; i < SIZE; i++) {
-        threatenedPieces[i] = 0;
+        switch (chrom[i]) {
+            case 'Q': attacked |= queenAttacks[i]; break;
+            case 'R': attacked |= rookAttacks[i]; break;
+            case 'B': attacked |= bishopAttacks[i]; break;
+            case 'K': attacked |= knightAttacks[i]; break;
+            default: continue;
+        }
+        occupied |= (unsigned short)(1 << i);
     }
     
+    // A piece is threatened when its square is attacked by any other piece
+    unsigned short threatened = attacked & occupied;
     for (int i = 0; i < SIZE; i++) {
-        if (chrom[i] == 'E') continue;
-        
-        int r1 = i / COLS;
-        int c1 = i % COLS;
-        char p1 = chrom[i];
-        
-        for (int j = i + 1; j < SIZE; j++) {
-            if (chrom[j] == 'E') continue;
-            
-            int r2 = j / COLS;
-            int c2 = j % COLS;
-            int threatFromItoJ = 0;
-            int threatFromJtoI = 0;
-            
-            if (p1 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromItoJ = 1;
-            } else if (p1 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromItoJ = 1;
-            } else if (p1 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromItoJ = 1;
-            }
-            
-            char p2 = chrom[j];
-            if (p2 == 'Q') {
-                if (r1 == r2 || c1 == c2 || abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'R') {
-                if (r1 == r2 || c1 == c2)
-                    threatFromJtoI = 1;
-            } else if (p2 == 'B') {
-                if (abs(r1 - r2) == abs(c1 - c2))
-                    threatFromJtoI = 1;
-            } else if (p2 == 'K') {
-                if ((abs(r1 - r2) == 2 && abs(c1 - c2) == 1) ||
-                    (abs(r1 - r2) == 1 && abs(c1 - c2) == 2))
-                    threatFromJtoI = 1;
-            }
-            
-            if (threatFromItoJ && !threatenedPieces[j]) {
-                threatenedPieces[j] = 1;
-                numThreatened++;
-            }
-            if (threatFromJtoI && !threatenedPieces[i]) {
-                threatenedPieces[i] = 1;
-                numThreatened++;
-            }
-        }
+        threatenedPieces[i] = (threatened >> i) & 1;
     }
     
-    return numThreatened;
+    return __builtin_popcount(threatened);
 }
 
-double fitness(char chrom[]) {
+double scoreChromosome(char chrom[]) {
     int threatenedPieces[SIZE];
     int nb_conflicts = countThreatenedPieces(chrom, threatenedPieces);
     int penalty = calculatePenalty(chrom);
@@ -135,6 +129,115 @@ double fitness(char chrom[]) {
     return 1.0 / (1.0 + nb_conflicts + penalty);
 }
 
+// Memoised through the shared fitness cache
+double fitness(char chrom[]) {
+    CacheEntry *entry;
+    if (!cacheLookup(chrom, SIZE, &entry)) entry->fit = scoreChromosome(chrom);
+    return entry->fit;
+}
+
+
+// Per-chromosome threat counters. Every individual carries one, built when
+// the initial population is created and passed along with the chromosome
+// through crossover, mutation and replacement, so a swap or a place/remove
+// only updates the attack relations of the touched squares instead of
+// re-scoring the whole chromosome.
+typedef struct {
+    unsigned char attackers[16];     // Number of pieces attacking each square
+    unsigned char queensInCol[4];
+    unsigned short occupied;
+    int threatened;                  // Occupied squares with attackers > 0
+    int penalty;                     // Columns holding more than one queen
+} ThreatState;
+
+unsigned short attacksFrom(char piece, int pos) {
+    switch (piece) {
+        case 'Q': return queenAttacks[pos];
+        case 'R': return rookAttacks[pos];
+        case 'B': return bishopAttacks[pos];
+        case 'K': return knightAttacks[pos];
+    }
+    return 0;
+}
+
+// Put a piece on an empty square
+void placePiece(ThreatState *st, char chrom[], int pos, char piece) {
+    chrom[pos] = piece;
+    st->occupied |= (unsigned short)(1 << pos);
+    if (st->attackers[pos]) st->threatened++;
+    
+    unsigned short targets = attacksFrom(piece, pos);
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (st->attackers[j]++ == 0 && (st->occupied >> j & 1))
+            st->threatened++;
+    }
+    
+    if (piece == 'Q' && ++st->queensInCol[pos % COLS] == 2)
+        st->penalty++;
+}
+
+// Clear an occupied square
+void removePiece(ThreatState *st, char chrom[], int pos) {
+    char piece = chrom[pos];
+    
+    unsigned short targets = attacksFrom(piece, pos);
+    while (targets) {
+        int j = __builtin_ctz(targets);
+        targets &= targets - 1;
+        if (--st->attackers[j] == 0 && (st->occupied >> j & 1))
+            st->threatened--;
+    }
+    
+    if (st->attackers[pos]) st->threatened--;
+    st->occupied &= (unsigned short)~(1 << pos);
+    chrom[pos] = 'E';
+    
+    if (piece == 'Q' && st->queensInCol[pos % COLS]-- == 2)
+        st->penalty--;
+}
+
+void initThreatState(ThreatState *st, char chrom[]) {
+    for (int i = 0; i < SIZE; i++) st->attackers[i] = 0;
+    for (int c = 0; c < COLS; c++) st->queensInCol[c] = 0;
+    st->occupied = 0;
+    st->threatened = 0;
+    st->penalty = 0;
+    
+    for (int i = 0; i < SIZE; i++) {
+        if (chrom[i] != 'E') placePiece(st, chrom, i, chrom[i]);
+    }
+}
+
+// Swap two cells, updating only the attack relations of those squares
+void swapCells(ThreatState *st, char chrom[], int a, int b) {
+    char pa = chrom[a];
+    char pb = chrom[b];
+    if (pa == pb) return;
+    
+    if (pa != 'E') removePiece(st, chrom, a);
+    if (pb != 'E') removePiece(st, chrom, b);
+    if (pb != 'E') placePiece(st, chrom, a, pb);
+    if (pa != 'E') placePiece(st, chrom, b, pa);
+}
+
+// Rewrite cells [from, SIZE) of chrom to match target. Every changed cell
+// is cleared before any is filled, so a piece is only placed on an empty
+// square.
+void rewriteCells(ThreatState *st, char chrom[], const char target[], int from) {
+    for (int i = from; i < SIZE; i++) {
+        if (chrom[i] != target[i] && chrom[i] != 'E') removePiece(st, chrom, i);
+    }
+    for (int i = from; i < SIZE; i++) {
+        if (chrom[i] != target[i]) placePiece(st, chrom, i, target[i]);
+    }
+}
+
+double stateFitness(const ThreatState *st) {
+    return 1.0 / (1.0 + st->threatened + st->penalty);
+}
+
 void shuffle(char chrom[]) {
     for (int i = SIZE - 1; i > 0; i--) {
         int j = rand() % (i + 1);
@@ -172,8 +275,14 @@ void copyArray(char dest[], char src[]) {
         dest[i] = src[i];
 }
 
-void tournamentSelection(char population[][SIZE], double fitnessScores[],
-                         char selected[][SIZE], double selectedFitness[], int populationSize) 
+// Winners are returned as population indices in parents[]; crossover reads
+// them in place. available[] is caller-owned scratch for populationSize
+// indices: available[0..left) holds the individuals not selected yet, each
+// tournament moves TOURNAMENT_SIZE of them to the front with a partial
+// Fisher-Yates shuffle, and the winner is removed by swapping in the last
+// entry, so no draw is ever rejected.
+void tournamentSelection(char population[][SIZE], double fitnessScores[], int available[],
+                         int parents[], double selectedFitness[], int populationSize) 
 {
     printf("\n=== TOURNAMENT SELECTION START ===\n");
     
@@ -181,168 +290,197 @@ void tournamentSelection(char population[][SIZE], double fitnessScores[],
     if (selectedCount > populationSize) {
         selectedCount = populationSize;
     }
-    
-    for (int i = 0; i < selectedCount; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            selected[i][j] = 'E';
-        }
-    }
 
-    double tempFitnessScores[populationSize];
-    for (int k = 0; k < populationSize; k++) {
-        tempFitnessScores[k] = fitnessScores[k];
-    }
-    
     printf("Initial population for selection:\n");
     for (int k = 0; k < populationSize; k++) {
         printf("  %d: ", k);
         printArray(population[k], SIZE);
-        printf(" | Fitness = %.4f", tempFitnessScores[k]);
+        printf(" | Fitness = %.4f", fitnessScores[k]);
         int threatenedPieces[SIZE];
         int conflicts = countThreatenedPieces(population[k], threatenedPieces);
         int penalty = calculatePenalty(population[k]);
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
     
+    int left = populationSize;
+    for (int k = 0; k < populationSize; k++) {
+        available[k] = k;
+    }
+    
     for (int s = 0; s < selectedCount; s++) {
-        int a, b;
-        do {
-            a = rand() % populationSize;
-        } while (tempFitnessScores[a] == -1.0);
-        do {
-            b = rand() % populationSize;
-        } while (b == a || tempFitnessScores[b] == -1.0);
-
-        printf("\nTournament %d:", s+1);
-        printf("\n  Candidate %d: ", a);
-        printArray(population[a], SIZE);
-        printf(" | Fitness=%.4f", tempFitnessScores[a]);
-        int threatenedPiecesA[SIZE];
-        int conflictsA = countThreatenedPieces(population[a], threatenedPiecesA);
-        int penaltyA = calculatePenalty(population[a]);
-        printf(" | Conflicts: %d | Penalty: %d", conflictsA, penaltyA);
+        int k = TOURNAMENT_SIZE < left ? TOURNAMENT_SIZE : left;
         
-        printf("\n  Candidate %d: ", b);
-        printArray(population[b], SIZE);
-        printf(" | Fitness=%.4f", tempFitnessScores[b]);
-        int threatenedPiecesB[SIZE];
-        int conflictsB = countThreatenedPieces(population[b], threatenedPiecesB);
-        int penaltyB = calculatePenalty(population[b]);
-        printf(" | Conflicts: %d | Penalty: %d", conflictsB, penaltyB);
-        
-        int winner;
-        if (tempFitnessScores[a] > tempFitnessScores[b]) {
-            winner = a;
-            printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", a, tempFitnessScores[a]);
-        } else {
-            winner = b;
-            printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", b, tempFitnessScores[b]);
+        printf("\nTournament %d:", s+1);
+        int best = 0;
+        for (int j = 0; j < k; j++) {
+            int r = j + rand() % (left - j);
+            int temp = available[j];
+            available[j] = available[r];
+            available[r] = temp;
+            
+            int c = available[j];
+            printf("\n  Candidate %d: ", c);
+            printArray(population[c], SIZE);
+            printf(" | Fitness=%.4f", fitnessScores[c]);
+            int threatenedPiecesC[SIZE];
+            int conflictsC = countThreatenedPieces(population[c], threatenedPiecesC);
+            int penaltyC = calculatePenalty(population[c]);
+            printf(" | Conflicts: %d | Penalty: %d", conflictsC, penaltyC);
+            
+            if (fitnessScores[c] > fitnessScores[available[best]]) best = j;
         }
+        
+        int winner = available[best];
+        printf("\n  Winner: Candidate %d (Fitness=%.4f)\n", winner, fitnessScores[winner]);
 
-        copyArray(selected[s], population[winner]);
-        selectedFitness[s] = tempFitnessScores[winner];
-        tempFitnessScores[winner] = -1.0;
+        parents[s] = winner;
+        selectedFitness[s] = fitnessScores[winner];
+        available[best] = available[--left];
         
         printf("  Selected chromosome: ");
-        printArray(selected[s], SIZE);
+        printArray(population[winner], SIZE);
         int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[s], threatenedPieces);
-        int penalty = calculatePenalty(selected[s]);
+        int conflicts = countThreatenedPieces(population[winner], threatenedPieces);
+        int penalty = calculatePenalty(population[winner]);
         printf(" | Fitness: %.4f | Conflicts: %d | Penalty: %d\n", selectedFitness[s], conflicts, penalty);
     }
     
     printf("\n=== TOURNAMENT SELECTION END - Selected chromosomes ===\n");
     for (int i = 0; i < selectedCount; i++) {
         printf("Selected[%d]: ", i);
-        printArray(selected[i], SIZE);
+        printArray(population[parents[i]], SIZE);
         printf(" | Fitness: %.4f", selectedFitness[i]);
         int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(selected[i], threatenedPieces);
-        int penalty = calculatePenalty(selected[i]);
+        int conflicts = countThreatenedPieces(population[parents[i]], threatenedPieces);
+        int penalty = calculatePenalty(population[parents[i]]);
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
 }
 
-void crossover(char selected[][SIZE], double selectedFitness[],
-               char offspring[][SIZE], double offspringFitness[], int popSize, int selectedCount) 
+// Parents are read in place from population[parents[i]]; offspring slots
+// past the mating pool reuse it from the start. Each slot is written once.
+// A child starts as a copy of the parent that gives it cells [0, 8), counters
+// included, and only the cells of the second half that differ are rewritten.
+void crossover(char population[][SIZE], ThreatState states[], int parents[],
+               double selectedFitness[], char offspring[][SIZE], double offspringFitness[],
+               ThreatState offspringStates[], int popSize, int selectedCount) 
 {
-    for (int i = 0; i < popSize; i++) {
-        int parentIdx = i % selectedCount;
-        copyArray(offspring[i], selected[parentIdx]);
-        offspringFitness[i] = selectedFitness[parentIdx];
-    }
-
     for (int i = 0; i < popSize - 1; i += 2) {
+        int a = i % selectedCount;
+        int b = (i + 1) % selectedCount;
+        char *parent1 = population[parents[a]];
+        char *parent2 = population[parents[b]];
         double r = (double)rand() / RAND_MAX;
         
-        if (r < PC && (i+1) < popSize) {
-            char child1[SIZE], child2[SIZE];
-            
-            for (int k = 0; k < 8; k++) {
-                child1[k] = offspring[i][k];
-                child2[k] = offspring[i+1][k];
-            }
-            for (int k = 8; k < SIZE; k++) {
-                child1[k] = offspring[i+1][k];
-                child2[k] = offspring[i][k];
-            }
-            
-            copyArray(offspring[i], child1);
-            offspringFitness[i] = fitness(child1);
+        copyArray(offspring[i], parent1);
+        offspringStates[i] = states[parents[a]];
+        copyArray(offspring[i+1], parent2);
+        offspringStates[i+1] = states[parents[b]];
+        
+        if (r < PC) {
+            rewriteCells(&offspringStates[i], offspring[i], parent2, 8);
+            rewriteCells(&offspringStates[i+1], offspring[i+1], parent1, 8);
             
-            copyArray(offspring[i+1], child2);
-            offspringFitness[i+1] = fitness(child2);
+            offspringFitness[i] = stateFitness(&offspringStates[i]);
+            offspringFitness[i+1] = stateFitness(&offspringStates[i+1]);
+        } else {
+            offspringFitness[i] = selectedFitness[a];
+            offspringFitness[i+1] = selectedFitness[b];
         }
     }
+    
+    if (popSize % 2) {
+        int a = (popSize - 1) % selectedCount;
+        copyArray(offspring[popSize-1], population[parents[a]]);
+        offspringFitness[popSize-1] = selectedFitness[a];
+        offspringStates[popSize-1] = states[parents[a]];
+    }
 }
 
-void mutation(char population[][SIZE], double fitnessScores[],
-              int nQ, int nR, int nB, int nK, int popSize)
-{
+// Brings the piece counts back to the targets after crossover. The cells are
+// bucketed once into a free list and one position list per piece; every
+// rand() then picks a cell straight from a list, so the repair never retries
+// and takes at most SIZE picks however full the board is. Excess pieces are
+// removed first, which guarantees free cells for the missing ones. Every
+// change goes through removePiece/placePiece so the counters stay exact.
+void repairCounts(ThreatState *st, char chrom[], int nQ, int nR, int nB, int nK) {
     char pieces[4] = {'Q', 'R', 'B', 'K'};
     int targets[4] = {nQ, nR, nB, nK};
     
+    int freeCells[16], freeCount = 0;
+    int positions[4][16], counts[4] = {0};
+    for (int i = 0; i < SIZE; i++) {
+        if (chrom[i] == 'E') {
+            freeCells[freeCount++] = i;
+            continue;
+        }
+        for (int p = 0; p < 4; p++) {
+            if (chrom[i] == pieces[p]) positions[p][counts[p]++] = i;
+        }
+    }
+    
+    // Remove if too many
+    for (int p = 0; p < 4; p++) {
+        while (counts[p] > targets[p]) {
+            int k = rand() % counts[p];
+            int pos = positions[p][k];
+            positions[p][k] = positions[p][--counts[p]];
+            removePiece(st, chrom, pos);
+            freeCells[freeCount++] = pos;
+        }
+    }
+    
+    // Add if missing
+    for (int p = 0; p < 4; p++) {
+        while (counts[p] < targets[p] && freeCount > 0) {
+            int k = rand() % freeCount;
+            int pos = freeCells[k];
+            freeCells[k] = freeCells[--freeCount];
+            placePiece(st, chrom, pos, pieces[p]);
+            counts[p]++;
+        }
+    }
+}
+
+// Each individual's stored counters follow the swap and the count repair
+void mutation(char population[][SIZE], double fitnessScores[], ThreatState states[],
+              int nQ, int nR, int nB, int nK, int popSize)
+{
     for (int c = 0; c < popSize; c++) {
+        ThreatState *st = &states[c];
+        
         double r = (double)rand() / RAND_MAX;
         
         if (r < PM) {
             int p1 = rand() % SIZE;
             int p2 = rand() % SIZE;
-            char temp = population[c][p1];
-            population[c][p1] = population[c][p2];
-            population[c][p2] = temp;
-        }
-
-        for (int p = 0; p < 4; p++) {
-            int count = 0;
-            for (int i = 0; i < SIZE; i++)
-                if (population[c][i] == pieces[p]) count++;
-
-            while (count < targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == 'E') {
-                    population[c][pos] = pieces[p];
-                    count++;
-                }
-            }
-            
-            while (count > targets[p]) {
-                int pos = rand() % SIZE;
-                if (population[c][pos] == pieces[p]) {
-                    population[c][pos] = 'E';
-                    count--;
-                }
-            }
+            swapCells(st, population[c], p1, p2);
         }
         
-        fitnessScores[c] = fitness(population[c]);
+        repairCounts(st, population[c], nQ, nR, nB, nK);
+        
+        fitnessScores[c] = stateFitness(st);
     }
 }
 
-void replacement(char oldPopulation[][SIZE], double oldFitness[],
-                 char newPopulation[][SIZE], double newFitness[],
-                 char resultPopulation[][SIZE], double resultFitness[],
-                 int popSize) 
+// Fitness is 1 / (1 + threatened + penalty) with threatened <= SIZE and
+// penalty <= COLS, so the integer score recovered from it is an exact sort
+// key: ranking is a counting sort over at most MAX_SCORE + 1 keys instead of
+// a comparison sort
+#define MAX_SCORE (16 + 4)   // SIZE + COLS
+
+int fitnessKey(double fit) {
+    return (int)(1.0 / fit - 0.5);
+}
+
+// combined[], combinedFitness[] and order[] are caller-owned scratch with
+// room for 2 * popSize entries. The ranking only permutes indices in order[];
+// ties keep the combined order (old before new) and only the top popSize
+// chromosomes are copied out, each with its counters.
+void replacement(char oldPopulation[][SIZE], double oldFitness[], ThreatState oldStates[],
+                 char newPopulation[][SIZE], double newFitness[], ThreatState newStates[],
+                 char resultPopulation[][SIZE], double resultFitness[], ThreatState resultStates[],
+                 int popSize, char combined[][SIZE], double combinedFitness[], int order[]) 
 {
     printf("\n=== REPLACEMENT START ===\n");
     printf("Old population (size=%d):\n", popSize);
@@ -367,9 +505,6 @@ void replacement(char oldPopulation[][SIZE], double oldFitness[],
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
     
-    char combined[2 * popSize][SIZE];
-    double combinedFitness[2 * popSize];
-    
     for (int i = 0; i < popSize; i++) {
         copyArray(combined[i], oldPopulation[i]);
         combinedFitness[i] = oldFitness[i];
@@ -388,35 +523,40 @@ void replacement(char oldPopulation[][SIZE], double oldFitness[],
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
     
-    for (int i = 0; i < 2 * popSize - 1; i++) {
-        for (int j = 0; j < 2 * popSize - 1 - i; j++) {
-            if (combinedFitness[j] < combinedFitness[j + 1]) {
-                double tempFit = combinedFitness[j];
-                combinedFitness[j] = combinedFitness[j + 1];
-                combinedFitness[j + 1] = tempFit;
-                
-                char tempChrom[SIZE];
-                copyArray(tempChrom, combined[j]);
-                copyArray(combined[j], combined[j + 1]);
-                copyArray(combined[j + 1], tempChrom);
-            }
-        }
+    int start[MAX_SCORE + 1] = {0};
+    for (int i = 0; i < 2 * popSize; i++) {
+        start[fitnessKey(combinedFitness[i])]++;
+    }
+    
+    // Counts become the first rank of each score
+    int rank = 0;
+    for (int k = 0; k <= MAX_SCORE; k++) {
+        int count = start[k];
+        start[k] = rank;
+        rank += count;
+    }
+    
+    for (int i = 0; i < 2 * popSize; i++) {
+        order[start[fitnessKey(combinedFitness[i])]++] = i;
     }
     
     printf("\nCombined population after sorting (descending fitness):\n");
     for (int i = 0; i < 2 * popSize; i++) {
+        int c = order[i];
         printf("  Combined[%d]: ", i);
-        printArray(combined[i], SIZE);
-        printf(" | Fitness: %.4f", combinedFitness[i]);
+        printArray(combined[c], SIZE);
+        printf(" | Fitness: %.4f", combinedFitness[c]);
         int threatenedPieces[SIZE];
-        int conflicts = countThreatenedPieces(combined[i], threatenedPieces);
-        int penalty = calculatePenalty(combined[i]);
+        int conflicts = countThreatenedPieces(combined[c], threatenedPieces);
+        int penalty = calculatePenalty(combined[c]);
         printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     }
     
     for (int i = 0; i < popSize; i++) {
-        copyArray(resultPopulation[i], combined[i]);
-        resultFitness[i] = combinedFitness[i];
+        int c = order[i];
+        copyArray(resultPopulation[i], combined[c]);
+        resultFitness[i] = combinedFitness[c];
+        resultStates[i] = c < popSize ? oldStates[c] : newStates[c - popSize];
     }
     
     printf("\nFinal result population (top %d):\n", popSize);
@@ -432,49 +572,78 @@ void replacement(char oldPopulation[][SIZE], double oldFitness[],
     printf("\n=== REPLACEMENT END ===\n");
 }
 
-void evolutionLoop(char population[][SIZE], double fitnessScores[], 
-                   int nQ, int nR, int nB, int nK, int generations, int popSize) 
+// Scratch one generation takes: the selection pool and the combined
+// population replacement ranks, alignment padding included
+size_t generationArenaBytes(int popSize, int selectedCount) {
+    return arenaBytes(popSize * sizeof(int)) +              // available
+           arenaBytes(selectedCount * sizeof(int)) +        // parents
+           arenaBytes(selectedCount * sizeof(double)) +     // selectedFitness
+           arenaBytes(2 * popSize * SIZE) +                 // combined
+           arenaBytes(2 * popSize * sizeof(double)) +       // combinedFitness
+           arenaBytes(2 * popSize * sizeof(int));           // order
+}
+
+// The population, the offspring and the next generation with their
+// counters, plus one generation's scratch
+size_t runArenaBytes(int popSize, int selectedCount) {
+    return 3 * (arenaBytes(popSize * SIZE) + arenaBytes(popSize * sizeof(double)) +
+                arenaBytes(popSize * sizeof(ThreatState))) +
+           generationArenaBytes(popSize, selectedCount);
+}
+
+// Offspring and the next generation are taken from the arena once; the
+// generation scratch is taken after a mark that is rewound every generation
+void evolutionLoop(char population[][SIZE], double fitnessScores[], ThreatState states[],
+                   int nQ, int nR, int nB, int nK, int generations, int popSize,
+                   Arena *arena) 
 {
     printf("\n=== EVOLUTION LOOP START ===\n");
     
+    int selectedCount = 6;
+    if (selectedCount > popSize) {
+        selectedCount = popSize;
+    }
+    
+    char (*offspring)[SIZE] = arenaAlloc(arena, popSize * sizeof *offspring);
+    double *offspringFitness = arenaAlloc(arena, popSize * sizeof *offspringFitness);
+    ThreatState *offspringStates = arenaAlloc(arena, popSize * sizeof *offspringStates);
+    char (*newPopulation)[SIZE] = arenaAlloc(arena, popSize * sizeof *newPopulation);
+    double *newFitness = arenaAlloc(arena, popSize * sizeof *newFitness);
+    ThreatState *newStates = arenaAlloc(arena, popSize * sizeof *newStates);
+    if (!offspring || !offspringFitness || !offspringStates ||
+        !newPopulation || !newFitness || !newStates) {
+        printf("Cannot allocate buffers for a population of %d.\n", popSize);
+        generations = 0;
+    }
+    size_t generationMark = arenaMark(arena);
+    
     for (int gen = 1; gen <= generations; gen++) {
+        arenaRewind(arena, generationMark);
+        int *available = arenaAlloc(arena, popSize * sizeof *available);
+        int *parents = arenaAlloc(arena, selectedCount * sizeof *parents);
+        double *selectedFitness = arenaAlloc(arena, selectedCount * sizeof *selectedFitness);
+        char (*combined)[SIZE] = arenaAlloc(arena, 2 * popSize * sizeof *combined);
+        double *combinedFitness = arenaAlloc(arena, 2 * popSize * sizeof *combinedFitness);
+        int *order = arenaAlloc(arena, 2 * popSize * sizeof *order);
+        
         printf("\n\n================ GENERATION %d ================\n", gen);
         
         printPopulation(population, fitnessScores, popSize, "Current Population");
         
-        double currentFitness[popSize];
-        for (int i = 0; i < popSize; i++) {
-            currentFitness[i] = fitnessScores[i];
-        }
-
-        int selectedCount = 6;
-        if (selectedCount > popSize) {
-            selectedCount = popSize;
-        }
-        
-        char selected[selectedCount][SIZE];
-        double selectedFitness[selectedCount];
-        char offspring[popSize][SIZE];
-        double offspringFitness[popSize];
-        char newPopulation[popSize][SIZE];
-        double newFitness[popSize];
+        tournamentSelection(population, fitnessScores, available, parents, selectedFitness, popSize);
         
-        tournamentSelection(population, currentFitness, selected, selectedFitness, popSize);
+        crossover(population, states, parents, selectedFitness,
+                  offspring, offspringFitness, offspringStates, popSize, selectedCount);
         
-        for (int i = 0; i < popSize; i++) {
-            fitnessScores[i] = fitness(population[i]);
-        }
-
-        crossover(selected, selectedFitness, offspring, offspringFitness, popSize, selectedCount);
-        
-        mutation(offspring, offspringFitness, nQ, nR, nB, nK, popSize);
+        mutation(offspring, offspringFitness, offspringStates, nQ, nR, nB, nK, popSize);
         
-        replacement(population, fitnessScores, offspring, offspringFitness, 
-                    newPopulation, newFitness, popSize);
+        replacement(population, fitnessScores, states, offspring, offspringFitness, offspringStates,
+                    newPopulation, newFitness, newStates, popSize, combined, combinedFitness, order);
         
         for (int i = 0; i < popSize; i++) {
             copyArray(population[i], newPopulation[i]);
             fitnessScores[i] = newFitness[i];
+            states[i] = newStates[i];
         }
         
         double bestFit = fitnessScores[0];
@@ -517,10 +686,14 @@ void evolutionLoop(char population[][SIZE], double fitnessScores[],
         }
     }
     printf("\n=== EVOLUTION LOOP END ===\n");
+    
+    arenaRewind(arena, generationMark);
+    printCacheStats();
 }
 
 int main() {
     srand(time(NULL));
+    initAttackTables();
     
     printf("=== CHESS PIECE PLACEMENT GENETIC ALGORITHM ===\n");
     
@@ -588,8 +761,26 @@ int main() {
     int penalty = calculatePenalty(chromosome);
     printf(" | Conflicts: %d | Penalty: %d\n", conflicts, penalty);
     
-    char population[POPULATION_SIZE][SIZE];
-    double fitnessScores[POPULATION_SIZE];
+    int selectedCount = 6;
+    if (selectedCount > POPULATION_SIZE) {
+        selectedCount = POPULATION_SIZE;
+    }
+    
+    // Every buffer of the run comes from one arena; large populations would
+    // overflow the stack as VLAs
+    Arena arena;
+    char (*population)[SIZE] = NULL;
+    double *fitnessScores = NULL;
+    ThreatState *states = NULL;
+    if (arenaInit(&arena, runArenaBytes(POPULATION_SIZE, selectedCount))) {
+        population = arenaAlloc(&arena, POPULATION_SIZE * sizeof *population);
+        fitnessScores = arenaAlloc(&arena, POPULATION_SIZE * sizeof *fitnessScores);
+        states = arenaAlloc(&arena, POPULATION_SIZE * sizeof *states);
+    }
+    if (!population || !fitnessScores || !states) {
+        printf("Cannot allocate a population of %d.\n", POPULATION_SIZE);
+        return 1;
+    }
     
     printf("\n=== INITIAL POPULATION CREATION ===\n");
     for (int i = 0; i < POPULATION_SIZE; i++) {
@@ -606,7 +797,8 @@ int main() {
         printf("\n  After shuffle: ");
         printArray(population[i], SIZE);
         
-        fitnessScores[i] = fitness(population[i]);
+        initThreatState(&states[i], population[i]);
+        fitnessScores[i] = stateFitness(&states[i]);
         conflicts = countThreatenedPieces(population[i], threatenedPieces);
         penalty = calculatePenalty(population[i]);
         printf("\n  Fitness: %.4f | Conflicts: %d | Penalty: %d\n", 
@@ -618,41 +810,47 @@ int main() {
     
     printf("\n\n=== GENETIC ALGORITHM STEPS ===\n");
     
-    printf("\n\n=== STEP 1: TOURNAMENT SELECTION ===\n");
-    int selectedCount = 6;
-    if (selectedCount > POPULATION_SIZE) {
-        selectedCount = POPULATION_SIZE;
-    }
+    // The one-cycle walkthrough borrows the space evolutionLoop uses later
+    size_t cycleMark = arenaMark(&arena);
+    char (*finalPopulation)[SIZE] = arenaAlloc(&arena, POPULATION_SIZE * sizeof *finalPopulation);
+    double *finalFitness = arenaAlloc(&arena, POPULATION_SIZE * sizeof *finalFitness);
+    ThreatState *finalStates = arenaAlloc(&arena, POPULATION_SIZE * sizeof *finalStates);
+    char (*bestPopulation)[SIZE] = arenaAlloc(&arena, POPULATION_SIZE * sizeof *bestPopulation);
+    double *bestFitness = arenaAlloc(&arena, POPULATION_SIZE * sizeof *bestFitness);
+    ThreatState *bestStates = arenaAlloc(&arena, POPULATION_SIZE * sizeof *bestStates);
+    int *available = arenaAlloc(&arena, POPULATION_SIZE * sizeof *available);
+    int *parents = arenaAlloc(&arena, selectedCount * sizeof *parents);
+    double *selectedFitness = arenaAlloc(&arena, selectedCount * sizeof *selectedFitness);
+    char (*combined)[SIZE] = arenaAlloc(&arena, 2 * POPULATION_SIZE * sizeof *combined);
+    double *combinedFitness = arenaAlloc(&arena, 2 * POPULATION_SIZE * sizeof *combinedFitness);
+    int *order = arenaAlloc(&arena, 2 * POPULATION_SIZE * sizeof *order);
     
-    char selected[selectedCount][SIZE];
-    double selectedFitness[selectedCount];
-    double initialFitnessCopy[POPULATION_SIZE];
-    for(int i = 0; i < POPULATION_SIZE; i++) initialFitnessCopy[i] = fitnessScores[i];
-    tournamentSelection(population, initialFitnessCopy, selected, selectedFitness, POPULATION_SIZE);
+    printf("\n\n=== STEP 1: TOURNAMENT SELECTION ===\n");
+    tournamentSelection(population, fitnessScores, available, parents, selectedFitness, POPULATION_SIZE);
     
     printf("\n\n=== STEP 2: CROSSOVER ===\n");
-    char finalPopulation[POPULATION_SIZE][SIZE];
-    double finalFitness[POPULATION_SIZE];
-    crossover(selected, selectedFitness, finalPopulation, finalFitness, POPULATION_SIZE, selectedCount);
+    crossover(population, states, parents, selectedFitness, finalPopulation, finalFitness, finalStates,
+              POPULATION_SIZE, selectedCount);
     
     printf("\n\n=== STEP 3: MUTATION ===\n");
-    mutation(finalPopulation, finalFitness, nQ, nR, nB, nK, POPULATION_SIZE);
+    mutation(finalPopulation, finalFitness, finalStates, nQ, nR, nB, nK, POPULATION_SIZE);
     
     printf("\n\n=== STEP 4: REPLACEMENT ===\n");
-    char bestPopulation[POPULATION_SIZE][SIZE];
-    double bestFitness[POPULATION_SIZE];
-    replacement(population, fitnessScores, finalPopulation, finalFitness, bestPopulation, bestFitness, POPULATION_SIZE);
+    replacement(population, fitnessScores, states, finalPopulation, finalFitness, finalStates,
+                bestPopulation, bestFitness, bestStates, POPULATION_SIZE, combined, combinedFitness, order);
     
     for (int i = 0; i < POPULATION_SIZE; i++) {
         copyArray(population[i], bestPopulation[i]);
         fitnessScores[i] = bestFitness[i];
+        states[i] = bestStates[i];
     }
+    arenaRewind(&arena, cycleMark);
     
     printf("\n\n=== POPULATION AFTER ONE COMPLETE CYCLE ===\n");
     printPopulation(population, fitnessScores, POPULATION_SIZE, "Population after one cycle");
 
     printf("\n\n=== STARTING EVOLUTION LOOP FOR %d GENERATIONS ===\n", MAX_GENERATIONS);
-    evolutionLoop(population, fitnessScores, nQ, nR, nB, nK, MAX_GENERATIONS, POPULATION_SIZE);
+    evolutionLoop(population, fitnessScores, states, nQ, nR, nB, nK, MAX_GENERATIONS, POPULATION_SIZE, &arena);
     
     printf("\n\n=== FINAL RESULTS ===\n");
     printPopulation(population, fitnessScores, POPULATION_SIZE, "Final Population");
@@ -697,5 +895,6 @@ int main() {
     printf("\nPiece counts in best solution: Q=%d, R=%d, B=%d, K=%d\n", 
            qCount, rCount, bCount, kCount);
     
+    arenaFree(&arena);
     return 0;
 }
\ No newline at end of file